@@ -0,0 +1,7 @@
+#include "modo_lote.h"
+
+// Ejecutable del modo por lotes: solo enlaza el núcleo y QtCore
+int main(int argc, char *argv[])
+{
+    return ejecutarModoLote(argc, argv);
+}
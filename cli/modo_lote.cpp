@@ -0,0 +1,491 @@
+#include "modo_lote.h"
+#include "../data_estructures/gestor_datos.h"
+#include "../data_estructures/catalogo.h"
+#include "../system/analizador_trafico.h"
+#include "../system/cubo_poblacion.h"
+#include "../system/grupo_hilos.h"
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QCommandLineOption>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonValue>
+#include <QStringList>
+#include <QTextStream>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <limits>
+
+namespace {
+
+const char* const OPCION_LOTE = "--lote";
+
+// Columnas de un archivo CSV de escenarios; las ausentes toman el valor por defecto
+const QStringList COLUMNAS_ESCENARIO = {
+    "edadMin", "edadMax", "sexo", "requiereInternet", "espacio", "producto", "tipoEspacio", "umbral"
+};
+
+bool leerBooleano(const QString& texto)
+{
+    const QString t = texto.trimmed().toLower();
+    return t == "1" || t == "true" || t == "si" || t == "sí";
+}
+
+// Edad no negativa; false si el texto no es un entero
+bool leerEdad(const QString& texto, int& edad)
+{
+    bool ok = false;
+    const int valor = texto.trimmed().toInt(&ok);
+    if (!ok || valor < 0) {
+        return false;
+    }
+    edad = valor;
+    return true;
+}
+
+bool leerReal(const QString& texto, double& real)
+{
+    bool ok = false;
+    const double valor = texto.trimmed().toDouble(&ok);
+    if (!ok || !std::isfinite(valor)) {
+        return false;
+    }
+    real = valor;
+    return true;
+}
+
+// Escenario a partir de pares columna -> texto, sobre los valores por defecto.
+// Devuelve false si un campo numérico no es un número.
+bool escenarioDesdeCampos(const QMap<QString, QString>& campos, const EscenarioTrafico& base,
+                          EscenarioTrafico& e, QString& error)
+{
+    e = base;
+    if (campos.contains("edadMin") && !leerEdad(campos.value("edadMin"), e.cliente.edadMin)) {
+        error = QString("edadMin no es una edad: '%1'").arg(campos.value("edadMin"));
+        return false;
+    }
+    if (campos.contains("edadMax") && !leerEdad(campos.value("edadMax"), e.cliente.edadMax)) {
+        error = QString("edadMax no es una edad: '%1'").arg(campos.value("edadMax"));
+        return false;
+    }
+    if (campos.contains("sexo")) e.cliente.sexo = Catalogo::codificarSexo(campos.value("sexo"));
+    if (campos.contains("requiereInternet")) e.cliente.requiereInternet = leerBooleano(campos.value("requiereInternet"));
+    if (campos.contains("espacio")) e.espacio = campos.value("espacio");
+    if (campos.contains("producto")) e.producto = campos.value("producto");
+    if (campos.contains("tipoEspacio")) e.tipoEspacio = campos.value("tipoEspacio");
+    if (campos.contains("umbral") && !leerReal(campos.value("umbral"), e.umbralInfluenciabilidad)) {
+        error = QString("umbral no es un número: '%1'").arg(campos.value("umbral"));
+        return false;
+    }
+    return true;
+}
+
+// Valores numéricos de las opciones; si no son válidos avisan por stderr
+bool leerOpcionEntera(const QCommandLineParser& parser, const QCommandLineOption& opcion,
+                      qint64 minimo, qint64 maximo, qint64& valor)
+{
+    bool ok = false;
+    valor = parser.value(opcion).toLongLong(&ok);
+    if (!ok || valor < minimo || valor > maximo) {
+        std::cerr << "Valor no válido para --" << opcion.names()[0].toStdString() << ": '"
+                  << parser.value(opcion).toStdString() << "'" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool leerOpcionSemilla(const QCommandLineParser& parser, const QCommandLineOption& opcion, quint64& valor)
+{
+    bool ok = false;
+    valor = parser.value(opcion).toULongLong(&ok);
+    if (!ok) {
+        std::cerr << "Semilla no válida para --" << opcion.names()[0].toStdString() << ": '"
+                  << parser.value(opcion).toStdString() << "'" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool leerOpcionReal(const QCommandLineParser& parser, const QCommandLineOption& opcion, double& valor)
+{
+    if (!leerReal(parser.value(opcion), valor)) {
+        std::cerr << "Valor no válido para --" << opcion.names()[0].toStdString() << ": '"
+                  << parser.value(opcion).toStdString() << "'" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// JSON: un arreglo de objetos, o un objeto con el arreglo en "escenarios"
+bool leerEscenariosJSON(const QByteArray& datos, const EscenarioTrafico& base,
+                        QVector<EscenarioTrafico>& escenarios, QString& error)
+{
+    QJsonParseError errorJSON;
+    QJsonDocument documento = QJsonDocument::fromJson(datos, &errorJSON);
+    if (documento.isNull()) {
+        error = errorJSON.errorString();
+        return false;
+    }
+    QJsonArray lista = documento.isArray() ? documento.array()
+                                           : documento.object().value("escenarios").toArray();
+    for (const QJsonValue& valor : lista) {
+        if (!valor.isObject()) {
+            error = "cada escenario debe ser un objeto";
+            return false;
+        }
+        const QJsonObject objeto = valor.toObject();
+        QMap<QString, QString> campos;
+        for (const QString& columna : COLUMNAS_ESCENARIO) {
+            if (!objeto.contains(columna)) {
+                continue;
+            }
+            const QJsonValue campo = objeto.value(columna);
+            QString texto = campo.toString();
+            if (campo.isBool()) {
+                texto = campo.toBool() ? "1" : "0";
+            } else if (campo.isDouble()) {
+                texto = QString::number(campo.toDouble(), 'g', 17);
+            }
+            campos.insert(columna, texto);
+        }
+        EscenarioTrafico escenario;
+        if (!escenarioDesdeCampos(campos, base, escenario, error)) {
+            error = QString("escenario %1: %2").arg(escenarios.size()).arg(error);
+            return false;
+        }
+        escenarios.append(escenario);
+    }
+    return true;
+}
+
+// CSV: primera línea con los nombres de columna, separados por comas
+bool leerEscenariosCSV(const QByteArray& datos, const EscenarioTrafico& base,
+                       QVector<EscenarioTrafico>& escenarios, QString& error)
+{
+    const QStringList lineas = QString::fromUtf8(datos).split('\n');
+    QStringList encabezado;
+    for (int i = 0; i < lineas.size(); ++i) {
+        const QString linea = lineas[i].trimmed();
+        if (linea.isEmpty()) {
+            continue;
+        }
+        const QStringList valores = linea.split(',');
+        if (encabezado.isEmpty()) {
+            for (const QString& nombre : valores) {
+                encabezado.append(nombre.trimmed());
+            }
+            continue;
+        }
+        if (valores.size() != encabezado.size()) {
+            error = QString("línea %1: se esperaban %2 campos").arg(i + 1).arg(encabezado.size());
+            return false;
+        }
+        QMap<QString, QString> campos;
+        for (int c = 0; c < valores.size(); ++c) {
+            campos.insert(encabezado[c], valores[c].trimmed());
+        }
+        EscenarioTrafico escenario;
+        if (!escenarioDesdeCampos(campos, base, escenario, error)) {
+            error = QString("línea %1: %2").arg(i + 1).arg(error);
+            return false;
+        }
+        escenarios.append(escenario);
+    }
+    return true;
+}
+
+bool leerEscenarios(const QString& ruta, const EscenarioTrafico& base,
+                    QVector<EscenarioTrafico>& escenarios, QString& error)
+{
+    QFile archivo(ruta);
+    if (!archivo.open(QIODevice::ReadOnly)) {
+        error = "no se pudo abrir el archivo";
+        return false;
+    }
+    const QByteArray datos = archivo.readAll();
+    if (QFileInfo(ruta).suffix().toLower() == "json") {
+        return leerEscenariosJSON(datos, base, escenarios, error);
+    }
+    return leerEscenariosCSV(datos, base, escenarios, error);
+}
+
+QString campoCSV(const QString& texto)
+{
+    if (!texto.contains(',') && !texto.contains('"')) {
+        return texto;
+    }
+    QString escapado = texto;
+    escapado.replace("\"", "\"\"");
+    return "\"" + escapado + "\"";
+}
+
+void escribirCSV(const QVector<EscenarioTrafico>& escenarios, const QVector<ResultadoEscenario>& resultados)
+{
+    QTextStream salida(stdout);
+    salida << "escenario,edadMin,edadMax,sexo,requiereInternet,espacio,producto,tipoEspacio,umbral,"
+              "trafico,traficoConUplift,esperado,varianza,limiteInferior,limiteSuperior,"
+              "nivelConfianza,personasElegibles\n";
+    for (int i = 0; i < escenarios.size(); ++i) {
+        const EscenarioTrafico& e = escenarios[i];
+        const ResultadoEscenario& r = resultados[i];
+        salida << i << ',' << e.cliente.edadMin << ',' << e.cliente.edadMax << ','
+               << campoCSV(e.cliente.nombreSexo()) << ',' << (e.cliente.requiereInternet ? 1 : 0) << ','
+               << campoCSV(e.espacio) << ',' << campoCSV(e.producto) << ',' << campoCSV(e.tipoEspacio) << ','
+               << e.umbralInfluenciabilidad << ',' << r.trafico << ','
+               << (r.traficoConUplift == ResultadoEscenario::SIN_MUESTREO ? QString()
+                                                                          : QString::number(r.traficoConUplift))
+               << ','
+               << QString::number(r.estimacion.esperado, 'f', 4) << ','
+               << QString::number(r.estimacion.varianza, 'f', 4) << ','
+               << QString::number(r.estimacion.limiteInferior, 'f', 4) << ','
+               << QString::number(r.estimacion.limiteSuperior, 'f', 4) << ','
+               << r.estimacion.nivelConfianza << ','
+               << static_cast<qlonglong>(r.estimacion.personasElegibles) << '\n';
+    }
+}
+
+void escribirJSON(const QVector<EscenarioTrafico>& escenarios, const QVector<ResultadoEscenario>& resultados)
+{
+    QJsonArray lista;
+    for (int i = 0; i < escenarios.size(); ++i) {
+        const EscenarioTrafico& e = escenarios[i];
+        const ResultadoEscenario& r = resultados[i];
+        QJsonObject objeto;
+        objeto["escenario"] = i;
+        objeto["edadMin"] = e.cliente.edadMin;
+        objeto["edadMax"] = e.cliente.edadMax;
+        objeto["sexo"] = e.cliente.nombreSexo();
+        objeto["requiereInternet"] = e.cliente.requiereInternet;
+        objeto["espacio"] = e.espacio;
+        objeto["producto"] = e.producto;
+        objeto["tipoEspacio"] = e.tipoEspacio;
+        objeto["umbral"] = e.umbralInfluenciabilidad;
+        objeto["trafico"] = r.trafico;
+        objeto["traficoConUplift"] = r.traficoConUplift == ResultadoEscenario::SIN_MUESTREO
+                                         ? QJsonValue() : QJsonValue(r.traficoConUplift);
+        objeto["esperado"] = r.estimacion.esperado;
+        objeto["varianza"] = r.estimacion.varianza;
+        objeto["limiteInferior"] = r.estimacion.limiteInferior;
+        objeto["limiteSuperior"] = r.estimacion.limiteSuperior;
+        objeto["nivelConfianza"] = r.estimacion.nivelConfianza;
+        objeto["personasElegibles"] = static_cast<double>(r.estimacion.personasElegibles);
+        lista.append(objeto);
+    }
+    QTextStream salida(stdout);
+    salida << QJsonDocument(lista).toJson(QJsonDocument::Indented);
+}
+
+} // namespace
+
+bool esModoLote(int argc, char *argv[])
+{
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], OPCION_LOTE) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+int ejecutarModoLote(int argc, char *argv[])
+{
+    QCoreApplication aplicacion(argc, argv);
+    
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Publicidad Efectiva - análisis por lotes sin interfaz gráfica");
+    parser.addHelpOption();
+    
+    QCommandLineOption opcionLote("lote", "Ejecutar en modo por lotes, sin interfaz gráfica");
+    QCommandLineOption opcionPoblacion("poblacion", "Población a analizar (CSV o instantánea)", "ruta");
+    QCommandLineOption opcionGenerar("generar", "Generar una población de n personas en memoria", "n");
+    QCommandLineOption opcionGuardarPoblacion("guardar-poblacion",
+                                              "Con --generar, escribir la población por lotes en un archivo "
+                                              "(CSV si termina en .csv, si no instantánea) y analizar ese archivo",
+                                              "ruta");
+    QCommandLineOption opcionSemillaPoblacion("semilla-poblacion", "Semilla de la población generada", "semilla",
+                                              QString::number(GeneradorPoblacion::SEMILLA_POR_DEFECTO));
+    QCommandLineOption opcionEscenarios("escenarios", "Archivo de escenarios (.json o .csv)", "ruta");
+    QCommandLineOption opcionEdadMin("edad-min", "Edad mínima del cliente", "edad", "18");
+    QCommandLineOption opcionEdadMax("edad-max", "Edad máxima del cliente", "edad", "65");
+    QCommandLineOption opcionSexo("sexo", "Sexo del cliente", "sexo", "Cualquiera");
+    QCommandLineOption opcionSinInternet("sin-internet", "El cliente no requiere acceso a internet");
+    QCommandLineOption opcionEspacio("espacio", "Distrito o plataforma", "espacio");
+    QCommandLineOption opcionProducto("producto", "Categoría del producto", "producto");
+    QCommandLineOption opcionTipoEspacio("tipo-espacio", "Tipo de espacio", "tipo", "Espacio Geográfico");
+    QCommandLineOption opcionUmbral("umbral", "Umbral de influenciabilidad", "umbral", "0.5");
+    QCommandLineOption opcionNivel("nivel-confianza", "Nivel del intervalo de confianza", "nivel", "0.95");
+    QCommandLineOption opcionHilos("hilos", "Hilos de la carga, la generación y el análisis (0 = todos)", "n", "0");
+    QCommandLineOption opcionSemilla("semilla", "Semilla de los sorteos del análisis (por omisión, una fija)", "semilla");
+    QCommandLineOption opcionSinMuestreo("sin-muestreo",
+                                         "Responder desde el cubo de la población, sin recorrer personas: "
+                                         "tráfico y valor esperado, sin el tráfico sorteado");
+    QCommandLineOption opcionFormato("formato", "Formato de salida: csv o json", "formato", "csv");
+    parser.addOptions({opcionLote, opcionPoblacion, opcionGenerar, opcionGuardarPoblacion,
+                       opcionSemillaPoblacion, opcionEscenarios,
+                       opcionEdadMin, opcionEdadMax, opcionSexo, opcionSinInternet, opcionEspacio,
+                       opcionProducto, opcionTipoEspacio, opcionUmbral, opcionNivel, opcionHilos,
+                       opcionSemilla, opcionSinMuestreo, opcionFormato});
+    parser.process(aplicacion);
+    
+    const QString formato = parser.value(opcionFormato).toLower();
+    if (formato != "csv" && formato != "json") {
+        std::cerr << "Formato de salida desconocido: " << formato.toStdString() << std::endl;
+        return 2;
+    }
+    if (parser.isSet(opcionPoblacion) == parser.isSet(opcionGenerar)) {
+        std::cerr << "Indique exactamente una de --poblacion o --generar" << std::endl;
+        return 2;
+    }
+    if (parser.isSet(opcionGuardarPoblacion) && !parser.isSet(opcionGenerar)) {
+        std::cerr << "--guardar-poblacion requiere --generar" << std::endl;
+        return 2;
+    }
+    // Sin escenarios ni espacio, --guardar-poblacion solo genera el archivo
+    const bool soloGuardar = parser.isSet(opcionGuardarPoblacion) && !parser.isSet(opcionEscenarios) &&
+                             !parser.isSet(opcionEspacio) && !parser.isSet(opcionProducto);
+    
+    // Opciones numéricas: un valor que no se entiende es un error, no un cero
+    const qint64 maximoInt = std::numeric_limits<int>::max();
+    qint64 edadMin = 0;
+    qint64 edadMax = 0;
+    qint64 personas = 0;
+    qint64 hilos = 0;
+    quint64 semillaPoblacion = 0;
+    quint64 semilla = 0;
+    double umbral = 0.0;
+    double nivel = 0.0;
+    if (!leerOpcionEntera(parser, opcionEdadMin, 0, maximoInt, edadMin) ||
+        !leerOpcionEntera(parser, opcionEdadMax, 0, maximoInt, edadMax) ||
+        !leerOpcionEntera(parser, opcionHilos, 0, maximoInt, hilos) ||
+        !leerOpcionSemilla(parser, opcionSemillaPoblacion, semillaPoblacion) ||
+        !leerOpcionReal(parser, opcionUmbral, umbral) ||
+        !leerOpcionReal(parser, opcionNivel, nivel)) {
+        return 2;
+    }
+    if (parser.isSet(opcionGenerar) &&
+        !leerOpcionEntera(parser, opcionGenerar, 1, std::numeric_limits<qint64>::max(), personas)) {
+        return 2;
+    }
+    if (parser.isSet(opcionSemilla) && !leerOpcionSemilla(parser, opcionSemilla, semilla)) {
+        return 2;
+    }
+    if (nivel <= 0.0 || nivel >= 1.0) {
+        std::cerr << "--nivel-confianza debe estar entre 0 y 1" << std::endl;
+        return 2;
+    }
+    
+    // --hilos limita también la carga y la generación, no solo el análisis
+    GrupoHilos::global().limitar(static_cast<int>(hilos));
+    
+    // Los argumentos sueltos forman el escenario por defecto y los valores
+    // que no fije el archivo de escenarios
+    EscenarioTrafico base(ClienteIdeal(static_cast<int>(edadMin), static_cast<int>(edadMax),
+                                       parser.value(opcionSexo), !parser.isSet(opcionSinInternet)),
+                          parser.value(opcionEspacio), parser.value(opcionProducto),
+                          parser.value(opcionTipoEspacio), umbral);
+    QVector<EscenarioTrafico> escenarios;
+    if (parser.isSet(opcionEscenarios)) {
+        QString error;
+        if (!leerEscenarios(parser.value(opcionEscenarios), base, escenarios, error)) {
+            std::cerr << "Error en los escenarios " << parser.value(opcionEscenarios).toStdString()
+                      << ": " << error.toStdString() << std::endl;
+            return 2;
+        }
+    } else if (!soloGuardar) {
+        if (base.espacio.isEmpty() || base.producto.isEmpty()) {
+            std::cerr << "Sin archivo de escenarios hacen falta --espacio y --producto" << std::endl;
+            return 2;
+        }
+        escenarios.append(base);
+    }
+    if (escenarios.isEmpty() && !soloGuardar) {
+        std::cerr << "No hay escenarios que analizar" << std::endl;
+        return 2;
+    }
+    
+    // Población
+    QElapsedTimer reloj;
+    reloj.start();
+    GestorDatos gestor;
+    QString ruta = parser.value(opcionPoblacion);
+    if (parser.isSet(opcionGuardarPoblacion)) {
+        // Directo a disco, con memoria constante; luego se analiza el archivo
+        ruta = parser.value(opcionGuardarPoblacion);
+        const GestorDatos::FormatoArchivo formatoArchivo = QFileInfo(ruta).suffix().toLower() == "csv"
+                                                               ? GestorDatos::FORMATO_CSV
+                                                               : GestorDatos::FORMATO_INSTANTANEA;
+        if (!gestor.generarPoblacionEnArchivo(ruta, personas, semillaPoblacion, formatoArchivo)) {
+            std::cerr << "No se pudo generar la población en " << ruta.toStdString() << std::endl;
+            return 1;
+        }
+        std::cerr << "Población generada en " << ruta.toStdString() << " (" << reloj.elapsed() << " ms)"
+                  << std::endl;
+        if (soloGuardar) {
+            return 0;
+        }
+        reloj.restart();
+    }
+    if (parser.isSet(opcionGenerar) && !parser.isSet(opcionGuardarPoblacion)) {
+        gestor.generarPoblacion(personas, semillaPoblacion);
+    } else {
+        if (InstantaneaPoblacion::esInstantanea(ruta)) {
+            gestor.cargarInstantanea(ruta);
+        } else {
+            gestor.cargarPoblacionDesdeCSV(ruta);
+        }
+    }
+    const PoblacionColumnar& poblacion = gestor.obtenerPoblacion();
+    if (poblacion.estaVacia()) {
+        std::cerr << "La población está vacía o no se pudo cargar" << std::endl;
+        return 1;
+    }
+    std::cerr << "Población: " << poblacion.tamano() << " personas (" << reloj.elapsed() << " ms)" << std::endl;
+    
+    // Los espacios desconocidos no fallan (dan 0), pero se avisa
+    for (int i = 0; i < escenarios.size(); ++i) {
+        const EscenarioTrafico& e = escenarios[i];
+        const bool geografico = e.tipoEspacio == "Espacio Geográfico";
+        const int codigo = geografico ? Catalogo::lugares().buscar(e.espacio)
+                                      : Catalogo::plataformas().buscar(e.espacio);
+        if (codigo < 0) {
+            std::cerr << "Aviso: escenario " << i << ": espacio desconocido '"
+                      << e.espacio.toStdString() << "'" << std::endl;
+        }
+    }
+    
+    // Análisis: todos los escenarios en una sola pasada
+    AnalizadorTrafico analizador;
+    analizador.establecerNumeroHilos(static_cast<int>(hilos));
+    if (parser.isSet(opcionSemilla)) {
+        analizador.establecerSemilla(semilla);
+    }
+    std::cerr << "Semilla del análisis: " << analizador.obtenerSemilla() << std::endl;
+    reloj.restart();
+    QVector<ResultadoEscenario> resultados;
+    if (parser.isSet(opcionSinMuestreo)) {
+        // El cubo cuesta una pasada; después cada escenario suma celdas
+        CuboPoblacion cubo;
+        if (!analizador.construirCubo(poblacion, cubo)) {
+            std::cerr << "El árbol de uplift tiene demasiadas hojas para el cubo" << std::endl;
+            return 1;
+        }
+        std::cerr << "Cubo: " << cubo.numCeldas() << " celdas (" << reloj.elapsed() << " ms)" << std::endl;
+        reloj.restart();
+        resultados = analizador.calcularEscenarios(cubo, escenarios, nivel);
+    } else {
+        analizador.calcularEscenarios(poblacion, escenarios, resultados, nivel);
+    }
+    std::cerr << "Escenarios: " << escenarios.size() << " (" << reloj.elapsed() << " ms)" << std::endl;
+    
+    if (formato == "json") {
+        escribirJSON(escenarios, resultados);
+    } else {
+        escribirCSV(escenarios, resultados);
+    }
+    return 0;
+}
@@ -0,0 +1,18 @@
+#ifndef MODO_LOTE_H
+#define MODO_LOTE_H
+
+// Modo por lotes sin interfaz gráfica (--lote). Usa solo QCoreApplication:
+// carga o genera una población (en memoria o directamente a un archivo), lee los escenarios de los argumentos o de
+// un archivo JSON/CSV, los evalúa en una sola pasada con
+// AnalizadorTrafico::calcularEscenarios y escribe los resultados en CSV o
+// JSON por la salida estándar. Los mensajes de avance y los errores van a
+// la salida de errores, para que la salida estándar pueda redirigirse.
+
+// True si los argumentos piden el modo por lotes; se consulta antes de
+// crear la aplicación para no inicializar los widgets
+bool esModoLote(int argc, char *argv[]);
+
+// Devuelve el código de salida del proceso
+int ejecutarModoLote(int argc, char *argv[]);
+
+#endif // MODO_LOTE_H
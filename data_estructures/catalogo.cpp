@@ -0,0 +1,101 @@
+#include "catalogo.h"
+#include <QReadLocker>
+#include <QWriteLocker>
+#include <QtGlobal>
+
+TablaSimbolos::TablaSimbolos()
+{
+    nombresPorCodigo.append(QString());
+    codigosPorNombre.insert(QString(), Catalogo::SIN_NOMBRE);
+}
+
+quint16 TablaSimbolos::internar(const QString& nombre)
+{
+    {
+        QReadLocker lectura(&candado);
+        auto it = codigosPorNombre.constFind(nombre);
+        if (it != codigosPorNombre.constEnd()) {
+            return it.value();
+        }
+    }
+
+    QWriteLocker escritura(&candado);
+    // Otro hilo pudo registrarlo entre ambos bloqueos
+    auto it = codigosPorNombre.constFind(nombre);
+    if (it != codigosPorNombre.constEnd()) {
+        return it.value();
+    }
+
+    if (nombresPorCodigo.size() >= MAX_NOMBRES) {
+        qFatal("TablaSimbolos: se superó el máximo de %d nombres", MAX_NOMBRES);
+    }
+    quint16 codigo = static_cast<quint16>(nombresPorCodigo.size());
+    nombresPorCodigo.append(nombre);
+    codigosPorNombre.insert(nombre, codigo);
+    return codigo;
+}
+
+int TablaSimbolos::buscar(const QString& nombre) const
+{
+    QReadLocker lectura(&candado);
+    auto it = codigosPorNombre.constFind(nombre);
+    return (it != codigosPorNombre.constEnd()) ? static_cast<int>(it.value()) : -1;
+}
+
+QString TablaSimbolos::nombre(quint16 codigo) const
+{
+    QReadLocker lectura(&candado);
+    return nombresPorCodigo.value(codigo);
+}
+
+int TablaSimbolos::tamano() const
+{
+    QReadLocker lectura(&candado);
+    return nombresPorCodigo.size();
+}
+
+QVector<QString> TablaSimbolos::nombres() const
+{
+    QReadLocker lectura(&candado);
+    return nombresPorCodigo;
+}
+
+TablaSimbolos& Catalogo::lugares()
+{
+    static TablaSimbolos tabla;
+    return tabla;
+}
+
+TablaSimbolos& Catalogo::plataformas()
+{
+    static TablaSimbolos tabla;
+    return tabla;
+}
+
+TablaSimbolos& Catalogo::productos()
+{
+    static TablaSimbolos tabla;
+    return tabla;
+}
+
+quint8 Catalogo::codificarSexo(const QString& sexo)
+{
+    if (sexo == "Masculino") return SEXO_MASCULINO;
+    if (sexo == "Femenino") return SEXO_FEMENINO;
+    if (sexo == "Cualquiera") return SEXO_CUALQUIERA;
+    return SEXO_DESCONOCIDO;
+}
+
+QString Catalogo::nombreSexo(quint8 codigo)
+{
+    switch (codigo) {
+        case SEXO_MASCULINO:
+            return "Masculino";
+        case SEXO_FEMENINO:
+            return "Femenino";
+        case SEXO_CUALQUIERA:
+            return "Cualquiera";
+        default:
+            return "";
+    }
+}
@@ -0,0 +1,59 @@
+#ifndef CATALOGO_H
+#define CATALOGO_H
+
+#include <QString>
+#include <QVector>
+#include <QHash>
+#include <QReadWriteLock>
+
+// Códigos compactos para el sexo de personas y clientes ideales
+enum CodigoSexo : quint8 {
+    SEXO_MASCULINO = 0,
+    SEXO_FEMENINO = 1,
+    SEXO_DESCONOCIDO = 2,
+    SEXO_CUALQUIERA = 3      // Solo válido en ClienteIdeal
+};
+
+// Tabla de símbolos internados: asigna a cada texto un entero pequeño y estable.
+// El código 0 está reservado para el texto vacío.
+class TablaSimbolos
+{
+public:
+    // Los códigos ocupan 16 bits: como mucho 65536 nombres, contando el vacío
+    static constexpr int MAX_NOMBRES = 65536;
+
+    TablaSimbolos();
+
+    // Devuelve el código del texto, registrándolo si aún no existe. Registrar
+    // más de MAX_NOMBRES nombres termina el programa con qFatal: repetir un
+    // código mezclaría en silencio a personas de lugares distintos.
+    quint16 internar(const QString& nombre);
+
+    // Devuelve el código del texto o -1 si no está registrado
+    int buscar(const QString& nombre) const;
+
+    QString nombre(quint16 codigo) const;
+    int tamano() const;
+    QVector<QString> nombres() const;
+
+private:
+    mutable QReadWriteLock candado;
+    QVector<QString> nombresPorCodigo;
+    QHash<QString, quint16> codigosPorNombre;
+};
+
+// Catálogo global de categorías compartido por datos, análisis y modelo
+class Catalogo
+{
+public:
+    static constexpr quint16 SIN_NOMBRE = 0;
+
+    static TablaSimbolos& lugares();        // Distritos y ubicaciones
+    static TablaSimbolos& plataformas();    // Plataformas digitales
+    static TablaSimbolos& productos();      // Categorías de productos
+
+    static quint8 codificarSexo(const QString& sexo);
+    static QString nombreSexo(quint8 codigo);
+};
+
+#endif // CATALOGO_H
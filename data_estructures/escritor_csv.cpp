@@ -0,0 +1,221 @@
+#include "escritor_csv.h"
+#include "esquema_csv.h"
+#include "../system/grupo_hilos.h"
+#include <QFileInfo>
+#include <QDir>
+#include <QByteArray>
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+// Cota del texto de un número: el double más largo en su forma más corta
+// ocupa 24 caracteres
+constexpr std::size_t MAX_NUMERO = 32;
+
+inline char* escribirTexto(char* p, const QByteArray& texto)
+{
+    std::memcpy(p, texto.constData(), static_cast<std::size_t>(texto.size()));
+    return p + texto.size();
+}
+
+template <typename T>
+inline char* escribirNumero(char* p, T valor)
+{
+    return std::to_chars(p, p + MAX_NUMERO, valor).ptr;
+}
+
+} // namespace
+
+// Nombres ya codificados en UTF-8, indexados por código
+struct EscritorCSV::NombresCSV {
+    std::vector<QByteArray> lugares;
+    QByteArray sexos[SEXO_CUALQUIERA + 1];
+    std::size_t maxLugar = 0;
+    std::size_t maxSexo = 0;
+
+    NombresCSV()
+    {
+        for (const QString& nombre : Catalogo::lugares().nombres()) {
+            lugares.push_back(nombre.toUtf8());
+            maxLugar = std::max(maxLugar, static_cast<std::size_t>(lugares.back().size()));
+        }
+        for (quint8 codigo = SEXO_MASCULINO; codigo <= SEXO_CUALQUIERA; ++codigo) {
+            sexos[codigo] = Catalogo::nombreSexo(codigo).toUtf8();
+            maxSexo = std::max(maxSexo, static_cast<std::size_t>(sexos[codigo].size()));
+        }
+    }
+
+    const QByteArray& lugar(quint16 codigo) const
+    {
+        static const QByteArray vacio;
+        return (codigo < lugares.size()) ? lugares[codigo] : vacio;
+    }
+
+    const QByteArray& sexo(quint8 codigo) const
+    {
+        static const QByteArray vacio;
+        return (codigo <= SEXO_CUALQUIERA) ? sexos[codigo] : vacio;
+    }
+
+    // Cota del texto de una fila del esquema completo
+    std::size_t maxFila() const
+    {
+        return 6 * MAX_NUMERO + maxSexo + 2 * maxLugar + NUM_CAMPOS_CSV;
+    }
+};
+
+namespace {
+
+// Formatea las filas [inicio, fin) en el orden de EsquemaCSV::completo
+template <typename Nombres>
+std::size_t formatearBloque(const ColumnasPoblacion& c, const Nombres& nombres,
+                            std::size_t inicio, std::size_t fin, char* salida)
+{
+    char* p = salida;
+    for (std::size_t i = inicio; i < fin; ++i) {
+        p = escribirNumero(p, c.id[i]);
+        *p++ = ',';
+        p = escribirNumero(p, static_cast<int>(c.edad[i]));
+        *p++ = ',';
+        p = escribirTexto(p, nombres.sexo(c.sexo[i]));
+        *p++ = ',';
+        *p++ = c.accesoInternet[i] ? '1' : '0';
+        *p++ = ',';
+        p = escribirTexto(p, nombres.lugar(c.distrito[i]));
+        *p++ = ',';
+        p = escribirNumero(p, c.ingresos[i]);
+        *p++ = ',';
+        p = escribirTexto(p, nombres.lugar(c.ubicacion[i]));
+        *p++ = ',';
+        p = escribirNumero(p, c.influenciabilidad[i]);
+        *p++ = ',';
+        p = escribirNumero(p, c.gasto[i]);
+        *p++ = '\n';
+    }
+    return static_cast<std::size_t>(p - salida);
+}
+
+} // namespace
+
+EscritorCSV::EscritorCSV(const QString& rutaArchivo, GrupoHilos* grupo)
+    : archivo(rutaArchivo), hilos(grupo ? *grupo : GrupoHilos::global())
+{
+}
+
+EscritorCSV::~EscritorCSV() = default;
+
+bool EscritorCSV::abrir()
+{
+    cronometro.start();
+    estadisticas = EstadisticasEscritura();
+
+    QDir dir = QFileInfo(archivo.fileName()).dir();
+    if (!dir.exists()) {
+        dir.mkpath(".");
+    }
+
+    correcto = archivo.open(QIODevice::WriteOnly);
+    if (!correcto) {
+        estadisticas.error = "No se pudo crear el archivo";
+        return false;
+    }
+
+    // Los nombres se fijan al abrir: los lotes no deben traer lugares nuevos
+    nombres = std::make_unique<NombresCSV>();
+
+    QByteArray encabezado = EsquemaCSV::completo().encabezado();
+    encabezado.append('\n');
+    correcto = archivo.write(encabezado) == encabezado.size();
+    estadisticas.bytes = encabezado.size();
+    if (!correcto) {
+        estadisticas.error = "Error de escritura";
+    }
+    return correcto;
+}
+
+bool EscritorCSV::escribir(const PoblacionColumnar& lote, const FuncionProgreso& progreso,
+                           const std::atomic<bool>* cancelado)
+{
+    if (!correcto) {
+        return false;
+    }
+
+    const ColumnasPoblacion columnas = lote.obtenerColumnas();
+    if (columnas.filas > 0 && columnas.maximoCodigoLugar() >= nombres->lugares.size()) {
+        estadisticas.error = "El lote usa un lugar posterior a la apertura del archivo";
+        correcto = false;
+        return false;
+    }
+    const std::size_t numBloques = (columnas.filas + FILAS_POR_BLOQUE - 1) / FILAS_POR_BLOQUE;
+
+    // Un búfer por hilo; cada ronda formatea tantos bloques como hilos
+    const std::size_t porRonda = static_cast<std::size_t>(hilos.tamano());
+    const std::size_t necesarios = std::min(porRonda, numBloques);
+    while (buferes.size() < necesarios) {
+        buferes.emplace_back(FILAS_POR_BLOQUE * nombres->maxFila());
+    }
+    std::vector<std::size_t> usados(necesarios);
+
+    for (std::size_t primero = 0; correcto && primero < numBloques; primero += porRonda) {
+        if (cancelado && cancelado->load()) {
+            estadisticas.error = "Escritura cancelada";
+            correcto = false;
+            return false;
+        }
+        const std::size_t enRonda = std::min(porRonda, numBloques - primero);
+        hilos.ejecutar(enRonda, [&](std::size_t k) {
+            const std::size_t inicio = (primero + k) * FILAS_POR_BLOQUE;
+            const std::size_t fin = std::min(columnas.filas, inicio + FILAS_POR_BLOQUE);
+            usados[k] = formatearBloque(columnas, *nombres, inicio, fin, buferes[k].data());
+        });
+
+        for (std::size_t k = 0; correcto && k < enRonda; ++k) {
+            const qint64 tamano = static_cast<qint64>(usados[k]);
+            correcto = archivo.write(buferes[k].data(), tamano) == tamano;
+            estadisticas.bytes += tamano;
+        }
+
+        if (progreso) {
+            progreso(static_cast<int>((primero + enRonda) * 100 / numBloques));
+        }
+    }
+
+    if (correcto) {
+        estadisticas.filas += static_cast<qint64>(columnas.filas);
+    } else {
+        estadisticas.error = "Error de escritura";
+    }
+    return correcto;
+}
+
+EstadisticasEscritura EscritorCSV::cerrar()
+{
+    archivo.close();
+    estadisticas.exito = correcto;
+    estadisticas.segundos = cronometro.nsecsElapsed() / 1e9;
+    return estadisticas;
+}
+
+EstadisticasEscritura EscritorCSV::guardar(const QString& rutaArchivo,
+                                           const PoblacionColumnar& poblacion,
+                                           const FuncionProgreso& progreso,
+                                           const std::atomic<bool>* cancelado)
+{
+    EscritorCSV escritor(rutaArchivo);
+    if (escritor.abrir()) {
+        escritor.escribir(poblacion, progreso, cancelado);
+    }
+    if (progreso && poblacion.estaVacia()) {
+        progreso(100);
+    }
+    EstadisticasEscritura estadisticas = escritor.cerrar();
+
+    // Un CSV a medias se leería como una población más chica
+    if (!estadisticas.exito && cancelado && cancelado->load()) {
+        QFile::remove(rutaArchivo);
+    }
+    return estadisticas;
+}
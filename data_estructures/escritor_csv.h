@@ -0,0 +1,83 @@
+#ifndef ESCRITOR_CSV_H
+#define ESCRITOR_CSV_H
+
+#include "poblacion_columnar.h"
+#include <QString>
+#include <QFile>
+#include <QElapsedTimer>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <vector>
+
+class GrupoHilos;
+
+// Resultado de una escritura de población a CSV
+struct EstadisticasEscritura {
+    bool exito = false;                  // false si el archivo no pudo crearse o escribirse
+    QString error;                       // Motivo del fallo, vacío si exito
+    qint64 filas = 0;
+    qint64 bytes = 0;
+    double segundos = 0.0;
+
+    double filasPorSegundo() const { return segundos > 0.0 ? filas / segundos : 0.0; }
+};
+
+// Escritor de CSV de población con el esquema completo (EsquemaCSV::completo),
+// de modo que LectorCSV recupera todos los campos tal como estaban: los
+// números se escriben con std::to_chars en su forma más corta que vuelve
+// exactamente al mismo valor.
+//
+// Las filas se formatean por bloques en paralelo, cada hilo sobre un búfer
+// propio que se reutiliza, y los bloques se escriben en orden. Un mismo
+// escritor acepta varios lotes seguidos, así que una población puede
+// escribirse por partes sin tenerla entera en memoria.
+//
+// hilos es el grupo que formatea los bloques (nullptr = GrupoHilos::global()).
+// Quien escribe mientras otro hilo usa el grupo global, como el consumidor de
+// GeneradorPoblacion::generarEnLotes, debe pasar un grupo propio: ejecutar()
+// atiende una llamada a la vez y las dos etapas no se solaparían.
+class EscritorCSV
+{
+public:
+    using FuncionProgreso = std::function<void(int porcentaje)>;
+
+    static constexpr std::size_t FILAS_POR_BLOQUE = 32768;
+
+    explicit EscritorCSV(const QString& rutaArchivo, GrupoHilos* hilos = nullptr);
+    ~EscritorCSV();
+
+    EscritorCSV(const EscritorCSV&) = delete;
+    EscritorCSV& operator=(const EscritorCSV&) = delete;
+
+    // Crea el archivo y escribe el encabezado
+    bool abrir();
+
+    // Agrega las filas del lote; progreso avanza dentro del lote. Falla si
+    // el lote usa un lugar internado después de abrir() o si cancelado se
+    // activa antes de terminarlo (el archivo queda incompleto)
+    bool escribir(const PoblacionColumnar& lote, const FuncionProgreso& progreso = nullptr,
+                  const std::atomic<bool>* cancelado = nullptr);
+
+    EstadisticasEscritura cerrar();
+
+    // Escribe una población completa de una vez. Si se cancela, el archivo
+    // incompleto se borra
+    static EstadisticasEscritura guardar(const QString& rutaArchivo,
+                                         const PoblacionColumnar& poblacion,
+                                         const FuncionProgreso& progreso = nullptr,
+                                         const std::atomic<bool>* cancelado = nullptr);
+
+private:
+    struct NombresCSV;
+
+    QFile archivo;
+    GrupoHilos& hilos;
+    std::unique_ptr<NombresCSV> nombres;
+    std::vector<std::vector<char>> buferes;     // Uno por hilo, reutilizados entre lotes
+    QElapsedTimer cronometro;
+    EstadisticasEscritura estadisticas;
+    bool correcto = false;
+};
+
+#endif // ESCRITOR_CSV_H
@@ -0,0 +1,141 @@
+#include "esquema_csv.h"
+#include <algorithm>
+
+namespace {
+
+const char* const NOMBRES_CAMPOS[NUM_CAMPOS_CSV] = {
+    "Id", "Edad", "Sexo", "AccesoInternet", "Distrito",
+    "Ingresos", "Ubicacion", "Influenciabilidad", "Gasto"
+};
+
+// Sin estos campos una línea no describe a una persona
+const CampoCSV CAMPOS_OBLIGATORIOS[] = {
+    CAMPO_EDAD, CAMPO_SEXO, CAMPO_ACCESO_INTERNET, CAMPO_DISTRITO
+};
+
+inline bool esEspacio(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r' || c == '"';
+}
+
+inline std::string_view recortar(std::string_view texto)
+{
+    while (!texto.empty() && esEspacio(texto.front())) texto.remove_prefix(1);
+    while (!texto.empty() && esEspacio(texto.back())) texto.remove_suffix(1);
+    return texto;
+}
+
+inline bool mismoNombre(std::string_view a, const char* b)
+{
+    std::string_view nombre(b);
+    if (a.size() != nombre.size()) {
+        return false;
+    }
+    for (std::size_t i = 0; i < a.size(); ++i) {
+        char x = a[i];
+        char y = nombre[i];
+        if (x >= 'A' && x <= 'Z') x = static_cast<char>(x - 'A' + 'a');
+        if (y >= 'A' && y <= 'Z') y = static_cast<char>(y - 'A' + 'a');
+        if (x != y) return false;
+    }
+    return true;
+}
+
+} // namespace
+
+EsquemaCSV::EsquemaCSV()
+{
+    std::fill(std::begin(columna), std::end(columna), -1);
+}
+
+EsquemaCSV EsquemaCSV::completo()
+{
+    EsquemaCSV esquema;
+    for (int campo = 0; campo < NUM_CAMPOS_CSV; ++campo) {
+        esquema.columna[campo] = campo;
+    }
+    esquema.calcularMinimo();
+    return esquema;
+}
+
+EsquemaCSV EsquemaCSV::posicional()
+{
+    EsquemaCSV esquema;
+    for (int campo = CAMPO_EDAD; campo < NUM_CAMPOS_CSV; ++campo) {
+        esquema.columna[campo] = campo - 1;
+    }
+    esquema.calcularMinimo();
+    return esquema;
+}
+
+bool EsquemaCSV::desdeEncabezado(std::string_view encabezado, EsquemaCSV& esquema)
+{
+    esquema = EsquemaCSV();
+
+    int numColumnas = 0;
+    while (numColumnas < MAX_COLUMNAS) {
+        std::size_t coma = encabezado.find(',');
+        std::string_view nombre = recortar(encabezado.substr(0, coma));
+        for (int campo = 0; campo < NUM_CAMPOS_CSV; ++campo) {
+            if (esquema.columna[campo] < 0 && mismoNombre(nombre, NOMBRES_CAMPOS[campo])) {
+                esquema.columna[campo] = numColumnas;
+                break;
+            }
+        }
+        ++numColumnas;
+        if (coma == std::string_view::npos) {
+            break;
+        }
+        encabezado.remove_prefix(coma + 1);
+    }
+
+    for (CampoCSV campo : CAMPOS_OBLIGATORIOS) {
+        if (!esquema.tiene(campo)) {
+            return false;
+        }
+    }
+
+    // Encabezado escrito por versiones anteriores de guardarPoblacionEnCSV
+    const EsquemaCSV heredado = posicional();
+    esquema.admiteFilasCompletas = (numColumnas == 4 && !esquema.tiene(CAMPO_ID));
+    for (CampoCSV campo : CAMPOS_OBLIGATORIOS) {
+        esquema.admiteFilasCompletas = esquema.admiteFilasCompletas &&
+                                       esquema.columna[campo] == heredado.columna[campo];
+    }
+
+    esquema.calcularMinimo();
+    return true;
+}
+
+const char* EsquemaCSV::nombreCampo(CampoCSV campo)
+{
+    return NOMBRES_CAMPOS[campo];
+}
+
+QByteArray EsquemaCSV::encabezado() const
+{
+    // Campos presentes ordenados por columna
+    const char* nombres[MAX_COLUMNAS] = {};
+    int ultima = -1;
+    for (int campo = 0; campo < NUM_CAMPOS_CSV; ++campo) {
+        if (columna[campo] >= 0 && columna[campo] < MAX_COLUMNAS) {
+            nombres[columna[campo]] = NOMBRES_CAMPOS[campo];
+            ultima = std::max(ultima, columna[campo]);
+        }
+    }
+
+    QByteArray texto;
+    for (int i = 0; i <= ultima; ++i) {
+        if (i > 0) texto.append(',');
+        if (nombres[i]) texto.append(nombres[i]);
+    }
+    return texto;
+}
+
+void EsquemaCSV::calcularMinimo()
+{
+    columnasMinimas = 0;
+    for (CampoCSV campo : CAMPOS_OBLIGATORIOS) {
+        columnasMinimas = std::max(columnasMinimas, columna[campo] + 1);
+    }
+}
@@ -0,0 +1,54 @@
+#ifndef ESQUEMA_CSV_H
+#define ESQUEMA_CSV_H
+
+#include <QByteArray>
+#include <string_view>
+
+// Campos de una persona en el CSV de población
+enum CampoCSV : int {
+    CAMPO_ID = 0,
+    CAMPO_EDAD,
+    CAMPO_SEXO,
+    CAMPO_ACCESO_INTERNET,
+    CAMPO_DISTRITO,
+    CAMPO_INGRESOS,
+    CAMPO_UBICACION,
+    CAMPO_INFLUENCIABILIDAD,
+    CAMPO_GASTO,
+    NUM_CAMPOS_CSV
+};
+
+// Esquema de un CSV de población: en qué columna de la línea está cada campo.
+// El lector lo obtiene del encabezado y el escritor usa siempre el completo,
+// de modo que guardar y volver a cargar conserva todos los campos.
+struct EsquemaCSV {
+    static constexpr int MAX_COLUMNAS = 16;      // Columnas que se examinan por línea
+
+    int columna[NUM_CAMPOS_CSV];                 // Posición del campo o -1 si falta
+    int columnasMinimas = 0;                     // Menos columnas = línea malformada
+
+    // Antiguo encabezado de 4 campos con filas de 9 (id al inicio): las líneas
+    // de 9 columnas se leen con el esquema completo
+    bool admiteFilasCompletas = false;
+
+    EsquemaCSV();
+
+    bool tiene(CampoCSV campo) const { return columna[campo] >= 0; }
+
+    // Id,Edad,Sexo,AccesoInternet,Distrito,Ingresos,Ubicacion,Influenciabilidad,Gasto
+    static EsquemaCSV completo();
+
+    // Sin encabezado: Edad,Sexo,AccesoInternet,Distrito y opcionales en orden
+    static EsquemaCSV posicional();
+
+    // Esquema según los nombres del encabezado; false si faltan campos obligatorios
+    static bool desdeEncabezado(std::string_view encabezado, EsquemaCSV& esquema);
+
+    static const char* nombreCampo(CampoCSV campo);
+    QByteArray encabezado() const;
+
+private:
+    void calcularMinimo();
+};
+
+#endif // ESQUEMA_CSV_H
@@ -0,0 +1,119 @@
+#include "fuente_poblacion.h"
+#include <QElapsedTimer>
+#include <algorithm>
+#include <cstring>
+
+std::unique_ptr<FuentePoblacion> FuentePoblacion::crear(const QString& rutaArchivo, quint64 semilla)
+{
+    if (InstantaneaPoblacion::esInstantanea(rutaArchivo)) {
+        return std::make_unique<FuenteInstantanea>(rutaArchivo);
+    }
+    return std::make_unique<FuenteCSV>(rutaArchivo, semilla);
+}
+
+FuenteCSV::FuenteCSV(const QString& rutaArchivo, quint64 semilla, qint64 bytesPorLote)
+    : archivo(rutaArchivo)
+    , semilla(semilla)
+    , bytesPorLote(std::max<qint64>(1, bytesPorLote))
+{
+}
+
+bool FuenteCSV::abrir()
+{
+    if (!archivo.open(QIODevice::ReadOnly)) {
+        ultimoError = "No se pudo abrir el archivo";
+        return false;
+    }
+    bytesTotales = archivo.size();
+    estadisticas.exito = true;
+    return true;
+}
+
+bool FuenteCSV::leerLote(PoblacionColumnar& lote)
+{
+    lote.limpiar();
+    if (!archivo.isOpen()) {
+        ultimoError = "El archivo no está abierto";
+        return false;
+    }
+
+    QElapsedTimer cronometro;
+    cronometro.start();
+
+    while (!finArchivo || !pendiente.isEmpty()) {
+        // Completar el bloque; una línea más larga que el bloque sigue leyendo
+        if (!finArchivo) {
+            QByteArray bloque = archivo.read(bytesPorLote);
+            pendiente.append(bloque.constData(), bloque.size());
+            finArchivo = bloque.size() < bytesPorLote || archivo.atEnd();
+            // Una lectura corta antes del final es un error, no el fin del archivo
+            if (finArchivo && !archivo.atEnd()) {
+                ultimoError = "Error de lectura";
+                lote.limpiar();
+                return false;
+            }
+        }
+
+        const char* datos = pendiente.constData();
+        const char* fin = datos + pendiente.size();
+        if (!finArchivo) {
+            const char* ultimo = fin;
+            while (ultimo > datos && ultimo[-1] != '\n') {
+                --ultimo;
+            }
+            if (ultimo == datos) {
+                continue;
+            }
+            fin = ultimo;
+        }
+
+        const char* inicio = datos;
+        if (!encabezadoLeido) {
+            inicio = LectorCSV::leerEncabezado(datos, fin, esquema);
+            encabezadoLeido = true;
+        }
+
+        EstadisticasLectura parte = LectorCSV::analizarTexto(inicio, fin, esquema, lote, semilla,
+                                                             siguienteLinea, siguienteId, nullptr, hilos);
+        siguienteLinea += static_cast<quint64>(parte.lineas);
+        siguienteId += parte.filas;
+
+        const int consumidos = static_cast<int>(fin - datos);
+        bytesProcesados += consumidos;
+        pendiente.remove(0, consumidos);
+
+        estadisticas.filas += parte.filas;
+        estadisticas.lineas += parte.lineas;
+        estadisticas.lineasMalformadas += parte.lineasMalformadas;
+        estadisticas.camposInvalidos += parte.camposInvalidos;
+        estadisticas.bytes += consumidos;
+
+        // Un bloque solo con líneas vacías o malformadas no cuenta como lote
+        if (!lote.estaVacia()) {
+            break;
+        }
+    }
+
+    estadisticas.segundos += cronometro.nsecsElapsed() / 1e9;
+    return !lote.estaVacia();
+}
+
+FuenteInstantanea::FuenteInstantanea(const QString& rutaArchivo, bool verificar, std::size_t filasPorLote)
+    : lector(rutaArchivo, verificar)
+    , filasPorLote(std::max<std::size_t>(1, filasPorLote))
+{
+}
+
+bool FuenteInstantanea::abrir()
+{
+    ResultadoInstantanea resultado = lector.abrir();
+    ultimoError = resultado.error;
+    return resultado.exito;
+}
+
+bool FuenteInstantanea::leerLote(PoblacionColumnar& lote)
+{
+    bool leido = lector.leer(lote, filasPorLote);
+    ultimoError = lector.error();
+    return leido;
+}
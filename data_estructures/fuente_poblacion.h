@@ -0,0 +1,101 @@
+#ifndef FUENTE_POBLACION_H
+#define FUENTE_POBLACION_H
+
+#include "poblacion_columnar.h"
+#include "lector_csv.h"
+#include "instantanea_poblacion.h"
+#include <QString>
+#include <QFile>
+#include <QByteArray>
+#include <memory>
+
+// Población leída de un archivo por lotes de tamaño fijo, para recorrer
+// archivos que no caben en memoria. Cada lote reemplaza al anterior, así
+// que la memoria depende del tamaño del lote y no del archivo.
+class FuentePoblacion
+{
+public:
+    virtual ~FuentePoblacion() = default;
+
+    virtual bool abrir() = 0;
+
+    // Reemplaza el contenido de lote con las filas siguientes.
+    // Devuelve false cuando no quedan filas o ante un error (ver error()).
+    virtual bool leerLote(PoblacionColumnar& lote) = 0;
+
+    // Avance de la lectura, en las mismas unidades que total()
+    virtual qint64 posicion() const = 0;
+    virtual qint64 total() const = 0;
+
+    QString error() const { return ultimoError; }
+
+    // Grupo de hilos con el que la fuente prepara cada lote (nullptr =
+    // GrupoHilos::global()). Quien lee en un hilo aparte mientras otro
+    // analiza en el grupo global le da uno propio: ejecutar() atiende una
+    // llamada a la vez y la lectura no se solaparía con el análisis.
+    void establecerHilos(GrupoHilos* grupo) { hilos = grupo; }
+
+    // Elige la fuente según la firma del archivo: instantánea o CSV.
+    // La semilla solo se usa para los campos que falten en un CSV.
+    static std::unique_ptr<FuentePoblacion> crear(const QString& rutaArchivo, quint64 semilla);
+
+protected:
+    QString ultimoError;
+    GrupoHilos* hilos = nullptr;
+};
+
+// CSV leído por bloques de bytes. La última línea incompleta de cada bloque
+// pasa al siguiente, y la numeración de líneas e ids continúa entre lotes:
+// el resultado es el mismo que el de LectorCSV::cargar sobre todo el archivo.
+// Las unidades de avance son bytes.
+class FuenteCSV : public FuentePoblacion
+{
+public:
+    static constexpr qint64 BYTES_POR_LOTE = 32 * 1024 * 1024;
+
+    FuenteCSV(const QString& rutaArchivo, quint64 semilla, qint64 bytesPorLote = BYTES_POR_LOTE);
+
+    bool abrir() override;
+    bool leerLote(PoblacionColumnar& lote) override;
+    qint64 posicion() const override { return bytesProcesados; }
+    qint64 total() const override { return bytesTotales; }
+
+    // Acumuladas sobre los lotes leídos hasta ahora
+    const EstadisticasLectura& obtenerEstadisticas() const { return estadisticas; }
+
+private:
+    QFile archivo;
+    quint64 semilla;
+    qint64 bytesPorLote;
+    qint64 bytesTotales = 0;
+    qint64 bytesProcesados = 0;
+
+    QByteArray pendiente;                // Bytes leídos que aún no forman líneas completas
+    bool finArchivo = false;
+    bool encabezadoLeido = false;
+    EsquemaCSV esquema;
+    quint64 siguienteLinea = 0;
+    qint64 siguienteId = 1;
+    EstadisticasLectura estadisticas;
+};
+
+// Instantánea leída por lotes de filas; las unidades de avance son filas
+class FuenteInstantanea : public FuentePoblacion
+{
+public:
+    static constexpr std::size_t FILAS_POR_LOTE = 1 << 20;
+
+    explicit FuenteInstantanea(const QString& rutaArchivo, bool verificar = false,
+                               std::size_t filasPorLote = FILAS_POR_LOTE);
+
+    bool abrir() override;
+    bool leerLote(PoblacionColumnar& lote) override;
+    qint64 posicion() const override { return lector.filasLeidas(); }
+    qint64 total() const override { return lector.filas(); }
+
+private:
+    LectorInstantanea lector;
+    std::size_t filasPorLote;
+};
+
+#endif // FUENTE_POBLACION_H
@@ -0,0 +1,50 @@
+#ifndef GENERADOR_ALEATORIO_H
+#define GENERADOR_ALEATORIO_H
+
+#include <QtGlobal>
+
+// Generador aleatorio basado en contador (mezclador SplitMix64).
+// Cada número depende solo de (semilla, clave, flujo): no guarda estado,
+// no necesita bloqueos y da el mismo valor sin importar el orden o el hilo
+// en que se evalúe. La clave suele ser el id de la persona y el flujo
+// separa usos independientes sobre la misma persona.
+class GeneradorContador
+{
+public:
+    // Flujos reservados
+    static constexpr quint64 FLUJO_CONVERSION = 1;
+    static constexpr quint64 FLUJO_INGRESOS = 2;
+    static constexpr quint64 FLUJO_INFLUENCIABILIDAD = 3;
+    static constexpr quint64 FLUJO_GASTO = 4;
+    static constexpr quint64 FLUJO_EDAD = 5;
+    static constexpr quint64 FLUJO_SEXO = 6;
+    static constexpr quint64 FLUJO_ACCESO_INTERNET = 7;
+    static constexpr quint64 FLUJO_DISTRITO = 8;
+
+    static inline quint64 mezclar(quint64 x)
+    {
+        x += 0x9E3779B97F4A7C15ULL;
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+        return x ^ (x >> 31);
+    }
+
+    static inline quint64 valor(quint64 semilla, quint64 clave, quint64 flujo = 0)
+    {
+        return mezclar(mezclar(semilla ^ mezclar(flujo)) ^ clave);
+    }
+
+    // Número uniforme en [0, 1) con 53 bits de precisión
+    static inline double uniforme(quint64 semilla, quint64 clave, quint64 flujo = 0)
+    {
+        return static_cast<double>(valor(semilla, clave, flujo) >> 11) * (1.0 / 9007199254740992.0);
+    }
+
+    // Entero uniforme en [0, limite)
+    static inline quint32 acotado(quint64 semilla, quint64 clave, quint64 flujo, quint32 limite)
+    {
+        return static_cast<quint32>(((valor(semilla, clave, flujo) >> 32) * limite) >> 32);
+    }
+};
+
+#endif // GENERADOR_ALEATORIO_H
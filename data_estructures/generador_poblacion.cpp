@@ -0,0 +1,178 @@
+#include "generador_poblacion.h"
+#include "generador_aleatorio.h"
+#include "../system/grupo_hilos.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+GeneradorPoblacion::GeneradorPoblacion(quint64 semillaGeneracion, const QVector<quint16>& codigosDistritos)
+    : semilla(semillaGeneracion), distritos(codigosDistritos)
+{
+    // Tabla por edad: evita repetir la cadena de comparaciones por persona
+    for (int edad = 0; edad <= PoblacionColumnar::EDAD_MAXIMA; ++edad) {
+        probabilidadAcceso[edad] = probabilidadAccesoDigital(edad);
+    }
+}
+
+double GeneradorPoblacion::probabilidadAccesoDigital(int edad)
+{
+    if (edad >= 17 && edad <= 24) return 0.81;
+    if (edad >= 25 && edad <= 40) return 0.75;
+    if (edad >= 41 && edad <= 59) return 0.60;
+    if (edad >= 60) return 0.25;
+    return 0.50;
+}
+
+bool GeneradorPoblacion::generar(PoblacionColumnar& destino, qint64 cantidad,
+                                 const FuncionProgreso& progreso,
+                                 const std::atomic<bool>* cancelado) const
+{
+    destino.limpiar();
+    const std::size_t filas = static_cast<std::size_t>(std::max<qint64>(0, cantidad));
+    destino.redimensionar(filas);
+    llenarEnParalelo(destino, 0, filas, progreso, cancelado);
+
+    if (cancelado && cancelado->load()) {
+        destino.limpiar();
+        return false;
+    }
+    if (progreso && filas == 0) {
+        progreso(100);
+    }
+    return true;
+}
+
+bool GeneradorPoblacion::generarEnLotes(qint64 cantidad, const FuncionLote& consumir,
+                                        const FuncionProgreso& progreso,
+                                        std::size_t filasPorLote) const
+{
+    filasPorLote = std::max<std::size_t>(1, filasPorLote);
+
+    // Dos lotes que se alternan entre el generador y el hilo de E/S
+    PoblacionColumnar lotes[2];
+    std::deque<int> libres = {0, 1};
+    std::deque<int> llenos;
+    std::mutex mutex;
+    std::condition_variable cambio;
+    bool terminado = false;
+    bool fallo = false;
+    qint64 consumidas = 0;
+
+    std::thread escritor([&]() {
+        while (true) {
+            int lote;
+            {
+                std::unique_lock<std::mutex> bloqueo(mutex);
+                cambio.wait(bloqueo, [&]() { return !llenos.empty() || terminado; });
+                if (llenos.empty()) {
+                    return;
+                }
+                lote = llenos.front();
+                llenos.pop_front();
+            }
+
+            bool correcto = consumir(lotes[lote]);
+            qint64 hechas;
+            {
+                std::lock_guard<std::mutex> bloqueo(mutex);
+                fallo = fallo || !correcto;
+                consumidas += static_cast<qint64>(lotes[lote].tamano());
+                hechas = consumidas;
+                libres.push_back(lote);
+            }
+            cambio.notify_all();
+
+            if (progreso && cantidad > 0) {
+                progreso(static_cast<int>(hechas * 100 / cantidad));
+            }
+        }
+    });
+
+    for (qint64 primera = 0; primera < cantidad; primera += static_cast<qint64>(filasPorLote)) {
+        int lote;
+        {
+            std::unique_lock<std::mutex> bloqueo(mutex);
+            cambio.wait(bloqueo, [&]() { return !libres.empty() || fallo; });
+            if (fallo) {
+                break;
+            }
+            lote = libres.front();
+            libres.pop_front();
+        }
+
+        // redimensionar conserva la capacidad: la memoria no crece con la población
+        const std::size_t filas = static_cast<std::size_t>(
+            std::min<qint64>(static_cast<qint64>(filasPorLote), cantidad - primera));
+        lotes[lote].redimensionar(filas);
+        llenarEnParalelo(lotes[lote], primera, filas, nullptr);
+
+        {
+            std::lock_guard<std::mutex> bloqueo(mutex);
+            llenos.push_back(lote);
+        }
+        cambio.notify_all();
+    }
+
+    {
+        std::lock_guard<std::mutex> bloqueo(mutex);
+        terminado = true;
+    }
+    cambio.notify_all();
+    escritor.join();
+
+    if (progreso && cantidad <= 0) {
+        progreso(100);
+    }
+    return !fallo;
+}
+
+void GeneradorPoblacion::llenarEnParalelo(PoblacionColumnar& destino, qint64 primera, std::size_t cantidad,
+                                          const FuncionProgreso& progreso,
+                                          const std::atomic<bool>* cancelado) const
+{
+    const std::size_t numBloques = (cantidad + FILAS_POR_BLOQUE - 1) / FILAS_POR_BLOQUE;
+    std::atomic<std::size_t> bloquesHechos{0};
+    GrupoHilos::global().ejecutar(numBloques, [&](std::size_t bloque) {
+        if (cancelado && cancelado->load(std::memory_order_relaxed)) {
+            return;
+        }
+        const std::size_t inicio = bloque * FILAS_POR_BLOQUE;
+        const std::size_t fin = std::min(cantidad, inicio + FILAS_POR_BLOQUE);
+        generarFilas(destino, inicio, primera + static_cast<qint64>(inicio), fin - inicio);
+
+        std::size_t hechos = bloquesHechos.fetch_add(1) + 1;
+        if (progreso) {
+            progreso(static_cast<int>(hechos * 100 / numBloques));
+        }
+    });
+}
+
+void GeneradorPoblacion::generarFilas(PoblacionColumnar& destino, std::size_t filaDestino,
+                                      qint64 primera, std::size_t cantidad) const
+{
+    using G = GeneradorContador;
+    const quint32 numDistritos = static_cast<quint32>(distritos.size());
+    const quint32 rangoEdad = EDAD_MAXIMA - EDAD_MINIMA + 1;
+
+    for (std::size_t k = 0; k < cantidad; ++k) {
+        const quint64 clave = static_cast<quint64>(primera) + k;
+
+        int edad = EDAD_MINIMA + static_cast<int>(G::acotado(semilla, clave, G::FLUJO_EDAD, rangoEdad));
+        quint8 sexo = G::acotado(semilla, clave, G::FLUJO_SEXO, 2) == 0 ? SEXO_MASCULINO : SEXO_FEMENINO;
+        bool accesoInternet = G::uniforme(semilla, clave, G::FLUJO_ACCESO_INTERNET) < probabilidadAcceso[edad];
+        quint16 distrito = numDistritos > 0 ?
+            distritos[static_cast<int>(G::acotado(semilla, clave, G::FLUJO_DISTRITO, numDistritos))] :
+            Catalogo::SIN_NOMBRE;
+
+        double ingresos = 25000 + G::uniforme(semilla, clave, G::FLUJO_INGRESOS) * 75000;              // 25k-100k
+        double influenciabilidad = 0.2 + G::uniforme(semilla, clave, G::FLUJO_INFLUENCIABILIDAD) * 0.8; // 0.2-1.0
+        double gasto = 150 + G::uniforme(semilla, clave, G::FLUJO_GASTO) * 1850;                        // 150-2000
+
+        destino.establecerFila(filaDestino + k, static_cast<qint32>(clave + 1), static_cast<quint8>(edad),
+                               sexo, accesoInternet, distrito, distrito,
+                               ingresos, influenciabilidad, gasto);
+    }
+}
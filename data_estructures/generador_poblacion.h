@@ -0,0 +1,69 @@
+#ifndef GENERADOR_POBLACION_H
+#define GENERADOR_POBLACION_H
+
+#include "poblacion_columnar.h"
+#include <QVector>
+#include <atomic>
+#include <functional>
+
+// Generador de poblaciones sintéticas reproducible y paralelo.
+// Cada atributo de la persona i se sortea con GeneradorContador usando
+// (semilla, i) como clave, así que el resultado para una semilla es el
+// mismo sin importar cuántos hilos participen ni en qué orden se llenen
+// los bloques. Las filas se escriben directamente en columnas ya reservadas.
+class GeneradorPoblacion
+{
+public:
+    using FuncionProgreso = std::function<void(int porcentaje)>;
+
+    // Recibe cada lote generado; false detiene la generación
+    using FuncionLote = std::function<bool(const PoblacionColumnar& lote)>;
+
+    static constexpr quint64 SEMILLA_POR_DEFECTO = 0x5EED2024ULL;
+    static constexpr std::size_t FILAS_POR_BLOQUE = 65536;
+    static constexpr std::size_t FILAS_POR_LOTE = 4 * 1024 * 1024;
+
+    // Rango de edades generado: [EDAD_MINIMA, EDAD_MAXIMA]
+    static constexpr int EDAD_MINIMA = 15;
+    static constexpr int EDAD_MAXIMA = 80;
+
+    // distritos: códigos de Catalogo::lugares entre los que se reparte la población
+    GeneradorPoblacion(quint64 semilla, const QVector<quint16>& distritos);
+
+    // Reemplaza el contenido de destino por las personas [0, cantidad).
+    // Devuelve false, con destino vacío, si cancelado se activó a medias
+    bool generar(PoblacionColumnar& destino, qint64 cantidad,
+                 const FuncionProgreso& progreso = nullptr,
+                 const std::atomic<bool>* cancelado = nullptr) const;
+
+    // Genera las personas [0, cantidad) por lotes de filasPorLote y entrega
+    // cada lote a consumir en un hilo de E/S aparte, mientras se genera el
+    // siguiente. Solo hay dos lotes en memoria a la vez. El progreso avanza
+    // con los lotes consumidos. Devuelve false si consumir falló.
+    // La generación ocupa GrupoHilos::global(): si consumir trabaja en
+    // paralelo debe usar otro grupo, o esperaría a que termine cada lote.
+    bool generarEnLotes(qint64 cantidad, const FuncionLote& consumir,
+                        const FuncionProgreso& progreso = nullptr,
+                        std::size_t filasPorLote = FILAS_POR_LOTE) const;
+
+    // Escribe las personas [primera, primera + cantidad) desde la fila filaDestino.
+    // destino debe tener ya esas filas (redimensionar)
+    void generarFilas(PoblacionColumnar& destino, std::size_t filaDestino,
+                      qint64 primera, std::size_t cantidad) const;
+
+    // Probabilidad de acceso a internet según la edad
+    static double probabilidadAccesoDigital(int edad);
+
+private:
+    // Llena destino[0, cantidad) con las personas desde primera, en paralelo.
+    // Con cancelado activo los bloques restantes se saltan
+    void llenarEnParalelo(PoblacionColumnar& destino, qint64 primera, std::size_t cantidad,
+                          const FuncionProgreso& progreso,
+                          const std::atomic<bool>* cancelado = nullptr) const;
+
+    quint64 semilla;
+    QVector<quint16> distritos;
+    double probabilidadAcceso[PoblacionColumnar::EDAD_MAXIMA + 1];
+};
+
+#endif // GENERADOR_POBLACION_H
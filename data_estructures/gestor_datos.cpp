@@ -1,11 +1,13 @@
 #include "gestor_datos.h"
+#include "lector_csv.h"
+#include "escritor_csv.h"
+#include "generador_poblacion.h"
+#include "../system/grupo_hilos.h"
 #include <QFile>
-#include <QTextStream>
 #include <QRandomGenerator>
 #include <QStandardPaths>
 #include <QDir>
 #include <QDebug>
-#include <QRegularExpression>
 
 GestorDatos::GestorDatos()
 {
@@ -46,113 +48,135 @@ void GestorDatos::configurarEspacios()
         "Joyas y Bisutería",
         "Software y Aplicaciones"
     };
+    
+    // Registrar los nombres en el catálogo para que tengan códigos estables
+    for (const QString& distrito : espaciosGeograficos["Lima"]) {
+        Catalogo::lugares().internar(distrito);
+    }
+    for (const QString& plataforma : plataformasDigitales) {
+        Catalogo::plataformas().internar(plataforma);
+    }
+    for (const QString& producto : categoriasProductos) {
+        Catalogo::productos().internar(producto);
+    }
 }
 
-void GestorDatos::generarPoblacion(int tamaño)
+void GestorDatos::generarPoblacion(qint64 tamaño, quint64 semilla, const FuncionProgreso& progreso,
+                                   const std::atomic<bool>* cancelado)
 {
-    QRandomGenerator *random = QRandomGenerator::global();
-    poblacion.clear();
-    poblacion.reserve(tamaño);
-    
-    for (int i = 0; i < tamaño; ++i) {
-        int edad = random->bounded(15, 81); // Edad entre 15 y 80
-        QString sexo = obtenerSexoAleatorio();
-        bool accesoInternet = obtenerAccesoInternetAleatorio(edad);
-        QString distrito = obtenerDistritoAleatorio();
-        
-        // Generar valores aleatorios para los nuevos campos del modelo de uplift
-        double ingresos = 25000 + (QRandomGenerator::global()->generateDouble() * 75000); // 25k-100k
-        double influenciabilidad = 0.2 + (QRandomGenerator::global()->generateDouble() * 0.8); // 0.2-1.0
-        double gasto = 150 + (QRandomGenerator::global()->generateDouble() * 1850); // 150-2000
-        
-        poblacion.append(Persona(i + 1, edad, sexo, accesoInternet, distrito, 
-                               ingresos, distrito, influenciabilidad, gasto));
+    GeneradorPoblacion generador(semilla, obtenerCodigosDistritos());
+    if (!generador.generar(poblacion, tamaño, progreso, cancelado)) {
+        qDebug() << "Generación cancelada";
     }
+    actualizarIndices();
 }
 
-void GestorDatos::cargarPoblacionDesdeCSV(const QString& rutaArchivo)
+bool GestorDatos::generarPoblacionEnArchivo(const QString& rutaArchivo, qint64 tamaño, quint64 semilla,
+                                            FormatoArchivo formato, const FuncionProgreso& progreso)
 {
-    QFile archivo(rutaArchivo);
+    GeneradorPoblacion generador(semilla, obtenerCodigosDistritos());
     
-    if (!archivo.open(QIODevice::ReadOnly | QIODevice::Text)) {
-        qDebug() << "No se pudo abrir el archivo:" << rutaArchivo;
-        return;
-    }
+    // El escritor corre mientras se genera el lote siguiente en el grupo
+    // global: con un grupo propio, del tamaño que permite el tope de hilos,
+    // formatear y escribir se solapan con la generación
+    GrupoHilos hilosEscritura(GrupoHilos::global().tamano());
     
-    QTextStream in(&archivo);
-    poblacion.clear();
-    
-    // Saltar encabezado si existe
-    if (!in.atEnd()) {
-        QString primeraLinea = in.readLine();
-        QRegularExpression regex("^\\d+");
-        if (!regex.match(primeraLinea).hasMatch()) {
-            // Es un encabezado, no procesarlo
-        } else {
-            // Es datos, procesarlo
-            in.seek(0);
+    if (formato == FORMATO_INSTANTANEA) {
+        EscritorInstantanea escritor(rutaArchivo, tamaño, &hilosEscritura);
+        if (escritor.abrir()) {
+            generador.generarEnLotes(tamaño, [&](const PoblacionColumnar& lote) {
+                return escritor.escribir(lote);
+            }, progreso);
         }
-    }
-    
-    while (!in.atEnd()) {
-        QString linea = in.readLine().trimmed();
-        if (linea.isEmpty()) continue;
-        
-        QStringList datos = linea.split(',');
-        
-        if (datos.size() >= 4) {
-            int id = poblacion.size() + 1; // Generar ID secuencial
-            int edad = datos[0].toInt();
-            QString sexo = datos[1].trimmed();
-            bool accesoInternet = (datos[2].toInt() == 1);
-            QString distrito = datos[3].trimmed();
-            
-            // Si el CSV tiene más campos, usarlos; si no, generar valores por defecto
-            double ingresos = (datos.size() > 4) ? datos[4].toDouble() : 
-                              25000 + (QRandomGenerator::global()->generateDouble() * 75000);
-            QString ubicacion = (datos.size() > 5) ? datos[5].trimmed() : distrito;
-            double influenciabilidad = (datos.size() > 6) ? datos[6].toDouble() :
-                                      0.2 + (QRandomGenerator::global()->generateDouble() * 0.8);
-            double gasto = (datos.size() > 7) ? datos[7].toDouble() :
-                          150 + (QRandomGenerator::global()->generateDouble() * 1850);
-            
-            poblacion.append(Persona(id, edad, sexo, accesoInternet, distrito, 
-                                   ingresos, ubicacion, influenciabilidad, gasto));
+        ResultadoInstantanea resultado = escritor.cerrar();
+        if (!resultado.exito) {
+            qDebug() << "No se pudo generar la instantánea" << rutaArchivo << ":" << resultado.error;
+            return false;
         }
+        qDebug() << "Generadas" << resultado.filas << "personas en instantánea en"
+                 << resultado.segundos << "s";
+        return true;
     }
     
-    archivo.close();
-    qDebug() << "Cargadas" << poblacion.size() << "personas desde CSV";
+    EscritorCSV escritor(rutaArchivo, &hilosEscritura);
+    if (escritor.abrir()) {
+        generador.generarEnLotes(tamaño, [&](const PoblacionColumnar& lote) {
+            return escritor.escribir(lote);
+        }, progreso);
+    }
+    EstadisticasEscritura escritura = escritor.cerrar();
+    if (!escritura.exito) {
+        qDebug() << "No se pudo generar el CSV" << rutaArchivo << ":" << escritura.error;
+        return false;
+    }
+    qDebug() << "Generadas" << escritura.filas << "personas en CSV en"
+             << escritura.segundos << "s (" << escritura.filasPorSegundo() << "filas/s)";
+    return true;
 }
 
-void GestorDatos::guardarPoblacionEnCSV(const QString& rutaArchivo)
+void GestorDatos::cargarPoblacionDesdeCSV(const QString& rutaArchivo, const FuncionProgreso& progreso,
+                                          const std::atomic<bool>* cancelado)
 {
-    // Crear directorio si no existe
-    QFileInfo info(rutaArchivo);
-    QDir dir = info.dir();
-    if (!dir.exists()) {
-        dir.mkpath(".");
-    }
-    
-    QFile archivo(rutaArchivo);
+    // Los campos opcionales ausentes se sortean con una semilla nueva en cada carga
+    ultimaLectura = LectorCSV::cargar(rutaArchivo, poblacion,
+                                      QRandomGenerator::global()->generate64(), progreso, cancelado);
     
-    if (!archivo.open(QIODevice::WriteOnly | QIODevice::Text)) {
-        qDebug() << "No se pudo crear el archivo:" << rutaArchivo;
+    if (!ultimaLectura.exito && cancelado && cancelado->load()) {
+        // La lectura cancelada dejó la población vacía
+        actualizarIndices();
+        qDebug() << "Carga cancelada:" << rutaArchivo;
         return;
     }
+    if (!ultimaLectura.exito) {
+        qDebug() << "No se pudo abrir el archivo:" << rutaArchivo;
+        return;
+    }
+    actualizarIndices();
     
-    QTextStream out(&archivo);
+    qDebug() << "Cargadas" << ultimaLectura.filas << "personas desde CSV en"
+             << ultimaLectura.segundos << "s (" << ultimaLectura.filasPorSegundo() << "filas/s,"
+             << ultimaLectura.lineasMalformadas << "líneas malformadas,"
+             << ultimaLectura.camposInvalidos << "campos inválidos)";
+}
+
+void GestorDatos::guardarPoblacionEnCSV(const QString& rutaArchivo, const FuncionProgreso& progreso,
+                                        const std::atomic<bool>* cancelado)
+{
+    EstadisticasEscritura escritura = EscritorCSV::guardar(rutaArchivo, poblacion, progreso, cancelado);
+    if (!escritura.exito) {
+        qDebug() << "No se pudo guardar el CSV" << rutaArchivo << ":" << escritura.error;
+        return;
+    }
     
-    // Escribir encabezado
-    out << "Edad,Sexo,AccesoInternet,Distrito\n";
+    qDebug() << "Guardadas" << escritura.filas << "personas en CSV en"
+             << escritura.segundos << "s (" << escritura.filasPorSegundo() << "filas/s)";
+}
+
+bool GestorDatos::guardarInstantanea(const QString& rutaArchivo)
+{
+    ResultadoInstantanea resultado = InstantaneaPoblacion::guardar(rutaArchivo, poblacion);
+    if (!resultado.exito) {
+        qDebug() << "No se pudo guardar la instantánea" << rutaArchivo << ":" << resultado.error;
+        return false;
+    }
     
-    // Escribir datos
-    for (const auto& persona : poblacion) {
-        out << persona.toString() << "\n";
+    qDebug() << "Guardadas" << resultado.filas << "personas en instantánea en"
+             << resultado.segundos << "s";
+    return true;
+}
+
+bool GestorDatos::cargarInstantanea(const QString& rutaArchivo, bool verificar)
+{
+    ResultadoInstantanea resultado = InstantaneaPoblacion::abrir(rutaArchivo, poblacion, verificar);
+    if (!resultado.exito) {
+        qDebug() << "No se pudo abrir la instantánea" << rutaArchivo << ":" << resultado.error;
+        return false;
     }
+    actualizarIndices();
     
-    archivo.close();
-    qDebug() << "Guardadas" << poblacion.size() << "personas en CSV";
+    qDebug() << "Abierta instantánea con" << resultado.filas << "personas en"
+             << resultado.segundos << "s" << (resultado.columnasTraducidas ? "(códigos traducidos)" : "");
+    return true;
 }
 
 QVector<QString> GestorDatos::obtenerDistritos() const
@@ -170,29 +194,17 @@ QVector<QString> GestorDatos::obtenerCategoriasProductos() const
     return categoriasProductos;
 }
 
-QString GestorDatos::obtenerDistritoAleatorio()
-{
-    QVector<QString> distritos = espaciosGeograficos["Lima"];
-    int indice = QRandomGenerator::global()->bounded(distritos.size());
-    return distritos[indice];
-}
-
-QString GestorDatos::obtenerSexoAleatorio()
+QVector<quint16> GestorDatos::obtenerCodigosDistritos() const
 {
-    return (QRandomGenerator::global()->bounded(2) == 0) ? "Masculino" : "Femenino";
-}
-
-bool GestorDatos::obtenerAccesoInternetAleatorio(int edad)
-{
-    double probabilidad = obtenerProbabilidadAccesoDigital(edad);
-    return QRandomGenerator::global()->generateDouble() < probabilidad;
+    QVector<quint16> codigos;
+    for (const QString& distrito : espaciosGeograficos.value("Lima")) {
+        codigos.append(Catalogo::lugares().internar(distrito));
+    }
+    return codigos;
 }
 
-double GestorDatos::obtenerProbabilidadAccesoDigital(int edad)
+void GestorDatos::actualizarIndices()
 {
-    if (edad >= 17 && edad <= 24) return 0.81;
-    if (edad >= 25 && edad <= 40) return 0.75;
-    if (edad >= 41 && edad <= 59) return 0.60;
-    if (edad >= 60) return 0.25;
-    return 0.50;
+    indiceDistritos.construir(poblacion);
+    indiceBitmap.construir(poblacion);
 }
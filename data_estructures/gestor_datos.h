@@ -2,22 +2,53 @@
 #define GESTOR_DATOS_H
 
 #include "../data_estructures/persona.h"
+#include "../data_estructures/poblacion_columnar.h"
+#include "../data_estructures/lector_csv.h"
+#include "../data_estructures/instantanea_poblacion.h"
+#include "../data_estructures/generador_poblacion.h"
+#include "../data_estructures/indice_distritos.h"
+#include "../data_estructures/indice_bitmap.h"
 #include <QVector>
 #include <QString>
 #include <QMap>
+#include <atomic>
+#include <functional>
 
 class GestorDatos
 {
 public:
     GestorDatos();
     
-    // Gestión de población
-    void generarPoblacion(int tamaño = 50000);
-    void cargarPoblacionDesdeCSV(const QString& rutaArchivo);
-    void guardarPoblacionEnCSV(const QString& rutaArchivo);
+    // Avance de una operación larga (0-100); puede invocarse desde otros hilos
+    using FuncionProgreso = std::function<void(int porcentaje)>;
+    
+    enum FormatoArchivo { FORMATO_CSV, FORMATO_INSTANTANEA };
+    
+    // Gestión de población. cancelado detiene generar, cargar o guardar
+    // desde otro hilo: la población queda vacía y no se deja un CSV a medias
+    void generarPoblacion(qint64 tamaño = 50000,
+                          quint64 semilla = GeneradorPoblacion::SEMILLA_POR_DEFECTO,
+                          const FuncionProgreso& progreso = nullptr,
+                          const std::atomic<bool>* cancelado = nullptr);
+    // Genera directamente a disco por lotes, con memoria constante; la
+    // población en memoria no cambia
+    bool generarPoblacionEnArchivo(const QString& rutaArchivo, qint64 tamaño, quint64 semilla,
+                                   FormatoArchivo formato, const FuncionProgreso& progreso = nullptr);
+    void cargarPoblacionDesdeCSV(const QString& rutaArchivo, const FuncionProgreso& progreso = nullptr,
+                                 const std::atomic<bool>* cancelado = nullptr);
+    void guardarPoblacionEnCSV(const QString& rutaArchivo, const FuncionProgreso& progreso = nullptr,
+                               const std::atomic<bool>* cancelado = nullptr);
+    
+    // Instantánea binaria: se abre mapeada y el análisis la recorre en el lugar
+    bool guardarInstantanea(const QString& rutaArchivo);
+    bool cargarInstantanea(const QString& rutaArchivo, bool verificar = false);
     
     // Acceso a datos
-    const QVector<Persona>& obtenerPoblacion() const { return poblacion; }
+    const PoblacionColumnar& obtenerPoblacion() const { return poblacion; }
+    const EstadisticasLectura& obtenerUltimaLectura() const { return ultimaLectura; }
+    // Se reconstruyen cada vez que cambia la población
+    const IndiceDistritos& obtenerIndiceDistritos() const { return indiceDistritos; }
+    const IndiceBitmap& obtenerIndiceBitmap() const { return indiceBitmap; }
     QVector<QString> obtenerDistritos() const;
     QVector<QString> obtenerPlataformasDigitales() const;
     QVector<QString> obtenerCategoriasProductos() const;
@@ -26,16 +57,17 @@ public:
     void configurarEspacios();
     
 private:
-    QVector<Persona> poblacion;
+    PoblacionColumnar poblacion;
+    IndiceDistritos indiceDistritos;
+    IndiceBitmap indiceBitmap;
+    EstadisticasLectura ultimaLectura;
     QMap<QString, QVector<QString>> espaciosGeograficos;
     QVector<QString> plataformasDigitales;
     QVector<QString> categoriasProductos;
     
     // Métodos auxiliares
-    QString obtenerDistritoAleatorio();
-    QString obtenerSexoAleatorio();
-    bool obtenerAccesoInternetAleatorio(int edad);
-    double obtenerProbabilidadAccesoDigital(int edad);
+    QVector<quint16> obtenerCodigosDistritos() const;
+    void actualizarIndices();
 };
 
 #endif // GESTOR_DATOS_H
@@ -0,0 +1,129 @@
+#include "indice_bitmap.h"
+#include "../system/grupo_hilos.h"
+#include <QtAlgorithms>
+#include <algorithm>
+
+void IndiceBitmap::limpiar()
+{
+    filas = 0;
+    palabras = 0;
+    edades.clear();
+    sexos.clear();
+    accesos.clear();
+    distritos.clear();
+}
+
+void IndiceBitmap::construir(const PoblacionColumnar& poblacion)
+{
+    limpiar();
+    const ColumnasPoblacion c = poblacion.obtenerColumnas();
+    filas = c.filas;
+    palabras = (filas + BITS_POR_PALABRA - 1) / BITS_POR_PALABRA;
+
+    int maxEdad = 0;
+    int maxSexo = SEXO_CUALQUIERA;
+    int maxDistrito = -1;
+    for (std::size_t fila = 0; fila < filas; ++fila) {
+        maxEdad = std::max<int>(maxEdad, c.edad[fila]);
+        maxSexo = std::max<int>(maxSexo, c.sexo[fila]);
+        maxDistrito = std::max<int>(maxDistrito, c.distrito[fila]);
+    }
+
+    edades.assign(static_cast<std::size_t>(maxEdad + 1), Mapa(palabras, 0));
+    sexos.assign(static_cast<std::size_t>(maxSexo + 1), Mapa(palabras, 0));
+    accesos.assign(palabras, 0);
+    distritos.assign(static_cast<std::size_t>(maxDistrito + 1), Mapa(palabras, 0));
+
+    // Cada bloque escribe solo sus propias palabras de cada mapa
+    const std::size_t numBloques = (palabras + PALABRAS_POR_BLOQUE - 1) / PALABRAS_POR_BLOQUE;
+    GrupoHilos::global().ejecutar(numBloques, [&](std::size_t bloque) {
+        const std::size_t primeraPalabra = bloque * PALABRAS_POR_BLOQUE;
+        const std::size_t finPalabras = std::min(primeraPalabra + PALABRAS_POR_BLOQUE, palabras);
+        const std::size_t inicio = primeraPalabra * BITS_POR_PALABRA;
+        const std::size_t fin = std::min(finPalabras * BITS_POR_PALABRA, filas);
+
+        // Primero un bit por valor exacto
+        for (std::size_t fila = inicio; fila < fin; ++fila) {
+            const std::size_t w = fila / BITS_POR_PALABRA;
+            const Palabra bit = Palabra(1) << (fila % BITS_POR_PALABRA);
+            edades[c.edad[fila]][w] |= bit;
+            sexos[c.sexo[fila]][w] |= bit;
+            if (c.accesoInternet[fila] != 0) {
+                accesos[w] |= bit;
+            }
+            distritos[c.distrito[fila]][w] |= bit;
+        }
+
+        // Luego se acumulan los rangos: edad <= a
+        for (std::size_t a = 1; a < edades.size(); ++a) {
+            for (std::size_t w = primeraPalabra; w < finPalabras; ++w) {
+                edades[a][w] |= edades[a - 1][w];
+            }
+        }
+    });
+}
+
+const IndiceBitmap::Palabra* IndiceBitmap::datos(const std::vector<Mapa>& mapas, std::size_t indice)
+{
+    return indice < mapas.size() ? mapas[indice].data() : nullptr;
+}
+
+const IndiceBitmap::Palabra* IndiceBitmap::edadHasta(int edad) const
+{
+    if (edad < 0 || edades.empty()) {
+        return nullptr;
+    }
+    return datos(edades, std::min(static_cast<std::size_t>(edad), edades.size() - 1));
+}
+
+const IndiceBitmap::Palabra* IndiceBitmap::sexo(quint8 codigo) const
+{
+    return datos(sexos, codigo);
+}
+
+const IndiceBitmap::Palabra* IndiceBitmap::accesoInternet() const
+{
+    return accesos.data();
+}
+
+const IndiceBitmap::Palabra* IndiceBitmap::distrito(int codigo) const
+{
+    return codigo >= 0 ? datos(distritos, static_cast<std::size_t>(codigo)) : nullptr;
+}
+
+qint64 IndiceBitmap::contar(const ConsultaBits& consulta) const
+{
+    if (consulta.rangos.empty() || palabras == 0) {
+        return 0;
+    }
+    for (const Palabra* mapa : consulta.requeridos) {
+        if (!mapa) {
+            return 0;
+        }
+    }
+
+    const std::size_t numBloques = (palabras + PALABRAS_POR_BLOQUE - 1) / PALABRAS_POR_BLOQUE;
+    std::vector<qint64> parciales(numBloques, 0);
+    GrupoHilos::global().ejecutar(numBloques, [&](std::size_t bloque) {
+        const std::size_t inicio = bloque * PALABRAS_POR_BLOQUE;
+        const std::size_t fin = std::min(inicio + PALABRAS_POR_BLOQUE, palabras);
+        qint64 cuenta = 0;
+        for (std::size_t w = inicio; w < fin; ++w) {
+            Palabra m = 0;
+            for (const ConsultaBits::Rango& rango : consulta.rangos) {
+                m |= rango.hasta[w] & (rango.excluir ? ~rango.excluir[w] : ~Palabra(0));
+            }
+            for (const Palabra* mapa : consulta.requeridos) {
+                m &= mapa[w];
+            }
+            cuenta += qPopulationCount(m);
+        }
+        parciales[bloque] = cuenta;
+    });
+
+    qint64 total = 0;
+    for (qint64 parcial : parciales) {
+        total += parcial;
+    }
+    return total;
+}
@@ -0,0 +1,62 @@
+#ifndef INDICE_BITMAP_H
+#define INDICE_BITMAP_H
+
+#include "poblacion_columnar.h"
+#include <vector>
+
+// Índice de mapas de bits sobre las columnas de pocos valores: un bit por
+// fila en cada mapa, en el orden de la población. Sexo, acceso a internet y
+// distrito tienen un mapa por valor; la edad usa codificación por rangos
+// (edad <= a), de modo que cualquier intervalo de edades sale de dos mapas.
+// Una consulta se reduce a AND/OR por palabras de 64 bits y el conteo sale
+// de contar bits, sin tocar las columnas.
+//
+// Ocupa del orden de (edades + distritos + sexos + 1) bits por persona; el
+// índice apunta a la población solo al construirse, así que hay que
+// reconstruirlo cada vez que esta cambie.
+class IndiceBitmap
+{
+public:
+    using Palabra = quint64;
+    static constexpr std::size_t BITS_POR_PALABRA = 64;
+    static constexpr std::size_t PALABRAS_POR_BLOQUE = 1024;
+
+    // Conjunción de mapas: (OR de los rangos) AND cada mapa requerido.
+    // Cada rango es hasta AND NOT excluir; excluir puede ser nulo.
+    struct ConsultaBits {
+        struct Rango {
+            const Palabra* hasta;
+            const Palabra* excluir;
+        };
+        std::vector<Rango> rangos;                  // Vacío: ninguna fila
+        std::vector<const Palabra*> requeridos;     // Un mapa nulo: ninguna fila
+    };
+
+    void construir(const PoblacionColumnar& poblacion);
+    void limpiar();
+
+    std::size_t tamano() const { return filas; }
+    std::size_t numPalabras() const { return palabras; }
+
+    // Mapas del índice; nulo si el valor queda fuera de los que aparecen
+    const Palabra* edadHasta(int edad) const;             // Filas con edad <= edad
+    const Palabra* sexo(quint8 codigo) const;
+    const Palabra* accesoInternet() const;
+    const Palabra* distrito(int codigo) const;
+
+    // Filas que cumplen la consulta; se recorre por bloques en paralelo
+    qint64 contar(const ConsultaBits& consulta) const;
+
+private:
+    using Mapa = std::vector<Palabra>;
+    static const Palabra* datos(const std::vector<Mapa>& mapas, std::size_t indice);
+
+    std::size_t filas = 0;
+    std::size_t palabras = 0;
+    std::vector<Mapa> edades;            // edades[a]: edad <= a
+    std::vector<Mapa> sexos;
+    Mapa accesos;
+    std::vector<Mapa> distritos;
+};
+
+#endif // INDICE_BITMAP_H
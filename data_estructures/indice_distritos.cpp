@@ -0,0 +1,109 @@
+#include "indice_distritos.h"
+#include <algorithm>
+
+void IndiceDistritos::limpiar()
+{
+    columnas = ColumnasPoblacion();
+    orden.clear();
+    orden.shrink_to_fit();
+    inicios.clear();
+}
+
+void IndiceDistritos::construir(const PoblacionColumnar& poblacion)
+{
+    limpiar();
+    columnas = poblacion.obtenerColumnas();
+    const ColumnasPoblacion& c = columnas;
+    const std::size_t filas = c.filas;
+
+    int maxDistrito = -1;
+    bool ordenada = true;
+    for (std::size_t fila = 0; fila < filas; ++fila) {
+        maxDistrito = std::max<int>(maxDistrito, c.distrito[fila]);
+        ordenada = ordenada && (fila == 0 || c.distrito[fila - 1] < c.distrito[fila] ||
+                                (c.distrito[fila - 1] == c.distrito[fila] && c.edad[fila - 1] <= c.edad[fila]));
+    }
+    const std::size_t numDistritos = static_cast<std::size_t>(maxDistrito + 1);
+
+    inicios.assign(numDistritos + 1, 0);
+    for (std::size_t fila = 0; fila < filas; ++fila) {
+        inicios[c.distrito[fila] + 1]++;
+    }
+    for (std::size_t d = 0; d < numDistritos; ++d) {
+        inicios[d + 1] += inicios[d];
+    }
+
+    if (!ordenada) {
+        // Ordenamiento por conteo en dos pasadas estables: primero por edad y
+        // luego por distrito, que deja las edades ordenadas dentro de cada distrito
+        std::vector<std::size_t> porEdad(filas);
+        {
+            std::size_t posiciones[256] = {};
+            for (std::size_t fila = 0; fila < filas; ++fila) {
+                posiciones[c.edad[fila]]++;
+            }
+            std::size_t acumulado = 0;
+            for (std::size_t& p : posiciones) {
+                std::size_t cantidad = p;
+                p = acumulado;
+                acumulado += cantidad;
+            }
+            for (std::size_t fila = 0; fila < filas; ++fila) {
+                porEdad[posiciones[c.edad[fila]]++] = fila;
+            }
+        }
+
+        orden.resize(filas);
+        std::vector<std::size_t> posiciones(inicios.begin(), inicios.begin() + numDistritos);
+        for (std::size_t fila : porEdad) {
+            orden[posiciones[c.distrito[fila]]++] = static_cast<quint32>(fila);
+        }
+    }
+}
+
+RangoFilas IndiceDistritos::rango(int distrito) const
+{
+    RangoFilas r;
+    if (distrito >= 0 && static_cast<std::size_t>(distrito) + 1 < inicios.size()) {
+        r.inicio = inicios[distrito];
+        r.fin = inicios[distrito + 1];
+    }
+    return r;
+}
+
+RangoFilas IndiceDistritos::rango(int distrito, int edadMin, int edadMax) const
+{
+    RangoFilas r = rango(distrito);
+    if (edadMin > edadMax) {
+        r.fin = r.inicio;
+        return r;
+    }
+
+    // Búsquedas binarias sobre las edades en el orden del índice
+    const quint8* edades = columnas.edad;
+    const int minimo = std::clamp(edadMin, 0, 256);
+    const int maximo = std::clamp(edadMax, -1, 255);
+    auto primeraPosicion = [&](std::size_t desde, std::size_t hasta, auto excede) {
+        while (desde < hasta) {
+            const std::size_t medio = desde + (hasta - desde) / 2;
+            if (excede(edades[filaEn(medio)])) {
+                hasta = medio;
+            } else {
+                desde = medio + 1;
+            }
+        }
+        return desde;
+    };
+    r.inicio = primeraPosicion(r.inicio, r.fin, [&](int edad) { return edad >= minimo; });
+    r.fin = primeraPosicion(r.inicio, r.fin, [&](int edad) { return edad > maximo; });
+    return r;
+}
+
+ColumnasPoblacion IndiceDistritos::filas(const RangoFilas& r, PoblacionColumnar& copia) const
+{
+    if (orden.empty()) {
+        return columnas.subrango(r.inicio, r.cantidad());
+    }
+    copia.reunirFilas(columnas, orden.data() + r.inicio, r.cantidad());
+    return copia.obtenerColumnas();
+}
@@ -0,0 +1,62 @@
+#ifndef INDICE_DISTRITOS_H
+#define INDICE_DISTRITOS_H
+
+#include "poblacion_columnar.h"
+#include <vector>
+
+// Posiciones [inicio, fin) en el orden del índice
+struct RangoFilas {
+    std::size_t inicio = 0;
+    std::size_t fin = 0;
+
+    std::size_t cantidad() const { return fin - inicio; }
+};
+
+// Índice por distrito y edad: una permutación de las filas ordenada por
+// distrito y, dentro de cada distrito, por edad. Cada distrito ocupa un
+// rango contiguo de la permutación, así que una consulta geográfica lee solo
+// las filas de su distrito y acota la edad del cliente con dos búsquedas
+// binarias. El orden es estable: dentro de una misma edad las filas
+// conservan el orden original.
+//
+// No modifica la población: sus filas conservan el orden de carga y las
+// columnas mapeadas se siguen leyendo en el lugar. Si la población ya viene
+// ordenada no se guarda permutación y los rangos son vistas directas. El
+// índice apunta a las columnas de la población: hay que reconstruirlo cada
+// vez que esta cambie.
+class IndiceDistritos
+{
+public:
+    void construir(const PoblacionColumnar& poblacion);
+    void limpiar();
+
+    std::size_t tamano() const { return columnas.filas; }
+    bool estaVacio() const { return columnas.filas == 0; }
+
+    // Toda la población, en su orden original
+    ColumnasPoblacion obtenerColumnas() const { return columnas; }
+
+    // True si la población ya estaba ordenada y no hizo falta permutación
+    bool esOrdenDirecto() const { return orden.empty(); }
+
+    // Filas de un distrito; vacío si el código no aparece
+    RangoFilas rango(int distrito) const;
+
+    // Filas de un distrito con edad en [edadMin, edadMax]
+    RangoFilas rango(int distrito, int edadMin, int edadMax) const;
+
+    // Columnas de las filas de un rango, en el orden del índice. Con orden
+    // directo es una vista sin copia; si no, las filas se copian a copia,
+    // que debe seguir viva mientras se use el resultado.
+    ColumnasPoblacion filas(const RangoFilas& r, PoblacionColumnar& copia) const;
+
+private:
+    // Fila de la población en la posición k del índice
+    std::size_t filaEn(std::size_t k) const { return orden.empty() ? k : orden[k]; }
+
+    ColumnasPoblacion columnas;
+    std::vector<quint32> orden;          // Vacío con orden directo; las filas caben en 32 bits como los ids
+    std::vector<std::size_t> inicios;    // inicios[d] .. inicios[d + 1] son las posiciones del distrito d
+};
+
+#endif // INDICE_DISTRITOS_H
@@ -0,0 +1,706 @@
+#include "instantanea_poblacion.h"
+#include "generador_aleatorio.h"
+#include "../system/grupo_hilos.h"
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+constexpr char FIRMA[8] = {'C', 'P', 'O', 'B', 'L', 'A', 'C', '\0'};
+constexpr quint32 MARCA_ORDEN = 0x01020304;
+
+// Columnas en el orden en que aparecen en el directorio
+enum ColumnaInstantanea : quint32 {
+    COLUMNA_ID = 0,
+    COLUMNA_EDAD,
+    COLUMNA_SEXO,
+    COLUMNA_ACCESO_INTERNET,
+    COLUMNA_DISTRITO,
+    COLUMNA_UBICACION,
+    COLUMNA_INGRESOS,
+    COLUMNA_INFLUENCIABILIDAD,
+    COLUMNA_GASTO,
+    NUM_COLUMNAS
+};
+
+constexpr quint32 ANCHOS[NUM_COLUMNAS] = {
+    sizeof(qint32), sizeof(quint8), sizeof(quint8), sizeof(quint8),
+    sizeof(quint16), sizeof(quint16), sizeof(double), sizeof(double), sizeof(double)
+};
+
+struct Encabezado {
+    char firma[8];
+    quint32 version;
+    quint32 marcaOrden;                  // Detecta archivos de otra arquitectura
+    quint64 filas;
+    quint32 numColumnas;
+    quint32 reservado;
+    quint64 inicioDiccionario;
+    quint64 bytesDiccionario;
+    quint64 sumaDiccionario;
+    quint64 sumaEncabezado;              // Encabezado y directorio, con este campo en 0
+};
+static_assert(sizeof(Encabezado) == 64, "El encabezado ocupa 64 bytes");
+
+struct EntradaColumna {
+    quint32 columna;
+    quint32 ancho;
+    quint64 inicio;
+    quint64 bytes;
+    quint64 suma;
+};
+static_assert(sizeof(EntradaColumna) == 32, "Cada entrada del directorio ocupa 32 bytes");
+
+constexpr std::size_t BYTES_CABECERA = sizeof(Encabezado) + NUM_COLUMNAS * sizeof(EntradaColumna);
+
+inline quint64 alinear(quint64 posicion)
+{
+    const quint64 a = InstantaneaPoblacion::ALINEACION;
+    return (posicion + a - 1) / a * a;
+}
+
+quint64 sumaCabecera(Encabezado encabezado, const EntradaColumna* directorio)
+{
+    encabezado.sumaEncabezado = 0;
+    QByteArray bytes(reinterpret_cast<const char*>(&encabezado), sizeof(Encabezado));
+    bytes.append(reinterpret_cast<const char*>(directorio), NUM_COLUMNAS * sizeof(EntradaColumna));
+    return InstantaneaPoblacion::sumaVerificacion(bytes.constData(), static_cast<std::size_t>(bytes.size()));
+}
+
+const void* punteroColumna(const ColumnasPoblacion& c, quint32 columna)
+{
+    switch (columna) {
+        case COLUMNA_ID: return c.id;
+        case COLUMNA_EDAD: return c.edad;
+        case COLUMNA_SEXO: return c.sexo;
+        case COLUMNA_ACCESO_INTERNET: return c.accesoInternet;
+        case COLUMNA_DISTRITO: return c.distrito;
+        case COLUMNA_UBICACION: return c.ubicacion;
+        case COLUMNA_INGRESOS: return c.ingresos;
+        case COLUMNA_INFLUENCIABILIDAD: return c.influenciabilidad;
+        case COLUMNA_GASTO: return c.gasto;
+        default: return nullptr;
+    }
+}
+
+// Diccionario: para cada tabla, número de códigos y luego (bytes, UTF-8) por código
+void escribirTabla(QByteArray& salida, const QVector<QString>& nombres)
+{
+    quint32 cantidad = static_cast<quint32>(nombres.size());
+    salida.append(reinterpret_cast<const char*>(&cantidad), sizeof(cantidad));
+    for (const QString& nombre : nombres) {
+        QByteArray utf8 = nombre.toUtf8();
+        quint16 largo = static_cast<quint16>(utf8.size());
+        salida.append(reinterpret_cast<const char*>(&largo), sizeof(largo));
+        salida.append(utf8.constData(), largo);
+    }
+}
+
+bool leerTabla(const char*& p, const char* fin, QVector<QString>& nombres)
+{
+    quint32 cantidad;
+    if (fin - p < static_cast<std::ptrdiff_t>(sizeof(cantidad))) return false;
+    std::memcpy(&cantidad, p, sizeof(cantidad));
+    p += sizeof(cantidad);
+
+    nombres.clear();
+    for (quint32 i = 0; i < cantidad; ++i) {
+        quint16 largo;
+        if (fin - p < static_cast<std::ptrdiff_t>(sizeof(largo))) return false;
+        std::memcpy(&largo, p, sizeof(largo));
+        p += sizeof(largo);
+        if (fin - p < largo) return false;
+        nombres.append(QString::fromUtf8(p, largo));
+        p += largo;
+    }
+    return true;
+}
+
+// Archivo mapeado más las columnas que hubo que traducir al catálogo actual
+struct ArchivoMapeado {
+    explicit ArchivoMapeado(const QString& ruta) : archivo(ruta) {}
+
+    QFile archivo;                       // Al destruirse libera el mapeo
+    std::vector<quint8> sexos;
+    std::vector<quint16> distritos;
+    std::vector<quint16> ubicaciones;
+};
+
+void* punteroColumna(const ColumnasEscritura& c, quint32 columna)
+{
+    switch (columna) {
+        case COLUMNA_ID: return c.id;
+        case COLUMNA_EDAD: return c.edad;
+        case COLUMNA_SEXO: return c.sexo;
+        case COLUMNA_ACCESO_INTERNET: return c.accesoInternet;
+        case COLUMNA_DISTRITO: return c.distrito;
+        case COLUMNA_UBICACION: return c.ubicacion;
+        case COLUMNA_INGRESOS: return c.ingresos;
+        case COLUMNA_INFLUENCIABILIDAD: return c.influenciabilidad;
+        case COLUMNA_GASTO: return c.gasto;
+        default: return nullptr;
+    }
+}
+
+// Admite origen == destino
+template <typename T>
+void traducir(const T* origen, T* destino, std::size_t filas, const std::vector<T>& tabla)
+{
+    for (std::size_t i = 0; i < filas; ++i) {
+        destino[i] = (origen[i] < tabla.size()) ? tabla[origen[i]] : T{};
+    }
+}
+
+template <typename T>
+const T* traducir(const T* origen, std::size_t filas, const std::vector<T>& tabla, std::vector<T>& destino)
+{
+    destino.resize(filas);
+    traducir(origen, destino.data(), filas, tabla);
+    return destino.data();
+}
+
+// Comprueba encabezado y directorio contra el tamaño del archivo.
+// Devuelve el motivo del fallo, o vacío si son válidos.
+QString validarCabecera(const char* cabecera, quint64 tamano, Encabezado& encabezado, EntradaColumna* directorio)
+{
+    std::memcpy(&encabezado, cabecera, sizeof(encabezado));
+    if (std::memcmp(encabezado.firma, FIRMA, sizeof(FIRMA)) != 0) {
+        return "No es una instantánea de población";
+    }
+    if (encabezado.marcaOrden != MARCA_ORDEN) {
+        return "Orden de bytes incompatible";
+    }
+    if (encabezado.version != InstantaneaPoblacion::VERSION) {
+        return QString("Versión %1 no soportada").arg(encabezado.version);
+    }
+    if (encabezado.numColumnas != NUM_COLUMNAS) {
+        return "Número de columnas inesperado";
+    }
+    std::memcpy(directorio, cabecera + sizeof(Encabezado), NUM_COLUMNAS * sizeof(EntradaColumna));
+    if (sumaCabecera(encabezado, directorio) != encabezado.sumaEncabezado) {
+        return "Encabezado dañado";
+    }
+
+    const quint64 filas = encabezado.filas;
+    for (quint32 c = 0; c < NUM_COLUMNAS; ++c) {
+        const EntradaColumna& entrada = directorio[c];
+        if (entrada.columna != c || entrada.ancho != ANCHOS[c] ||
+            entrada.bytes != filas * ANCHOS[c] || entrada.inicio % InstantaneaPoblacion::ALINEACION != 0 ||
+            entrada.inicio > tamano || entrada.bytes > tamano - entrada.inicio) {
+            return QString("Columna %1 fuera del archivo").arg(c);
+        }
+    }
+
+    if (encabezado.inicioDiccionario > tamano ||
+        encabezado.bytesDiccionario > tamano - encabezado.inicioDiccionario) {
+        return "Diccionario fuera del archivo";
+    }
+    return QString();
+}
+
+// Tablas que llevan los códigos del archivo a los del catálogo actual
+struct Traduccion {
+    std::vector<quint16> lugares;
+    std::vector<quint8> sexos;
+    bool lugaresIguales = true;
+    bool sexosIguales = true;
+};
+
+bool leerDiccionario(const char* inicio, const Encabezado& encabezado, Traduccion& traduccion)
+{
+    const char* fin = inicio + encabezado.bytesDiccionario;
+    if (InstantaneaPoblacion::sumaVerificacion(inicio, static_cast<std::size_t>(encabezado.bytesDiccionario)) !=
+        encabezado.sumaDiccionario) {
+        return false;
+    }
+    QVector<QString> lugares;
+    QVector<QString> sexos;
+    const char* p = inicio;
+    if (!leerTabla(p, fin, lugares) || !leerTabla(p, fin, sexos)) {
+        return false;
+    }
+
+    traduccion.lugares.resize(static_cast<std::size_t>(lugares.size()));
+    for (int i = 0; i < lugares.size(); ++i) {
+        traduccion.lugares[i] = Catalogo::lugares().internar(lugares[i]);
+        traduccion.lugaresIguales = traduccion.lugaresIguales && traduccion.lugares[i] == i;
+    }
+    traduccion.sexos.resize(static_cast<std::size_t>(sexos.size()));
+    for (int i = 0; i < sexos.size(); ++i) {
+        traduccion.sexos[i] = Catalogo::codificarSexo(sexos[i]);
+        traduccion.sexosIguales = traduccion.sexosIguales && traduccion.sexos[i] == i;
+    }
+    return true;
+}
+
+ResultadoInstantanea fallo(const QString& motivo)
+{
+    ResultadoInstantanea resultado;
+    resultado.error = motivo;
+    return resultado;
+}
+
+} // namespace
+
+namespace {
+
+// Cuatro acumuladores independientes para no encadenar multiplicaciones
+constexpr quint64 PRIMO_1 = 0x9E3779B185EBCA87ULL;
+constexpr quint64 PRIMO_2 = 0xC2B2AE3D27D4EB4FULL;
+constexpr std::size_t BYTES_RONDA = 32;
+
+inline quint64 ronda(quint64 acumulado, quint64 palabra)
+{
+    acumulado += palabra * PRIMO_2;
+    acumulado = (acumulado << 31) | (acumulado >> 33);
+    return acumulado * PRIMO_1;
+}
+
+inline void rondaBloque(quint64* acumulado, const unsigned char* p)
+{
+    for (int k = 0; k < 4; ++k) {
+        quint64 palabra;
+        std::memcpy(&palabra, p + k * 8, sizeof(palabra));
+        acumulado[k] = ronda(acumulado[k], palabra);
+    }
+}
+
+} // namespace
+
+SumaVerificacion::SumaVerificacion()
+    : acumulado{PRIMO_1 + PRIMO_2, PRIMO_2, 0, 0 - PRIMO_1}
+{
+}
+
+void SumaVerificacion::agregar(const void* datos, std::size_t bytes)
+{
+    const unsigned char* p = static_cast<const unsigned char*>(datos);
+    total += bytes;
+
+    // Completar el bloque pendiente de la llamada anterior
+    if (numPendiente > 0) {
+        std::size_t faltan = std::min(BYTES_RONDA - numPendiente, bytes);
+        std::memcpy(pendiente + numPendiente, p, faltan);
+        numPendiente += faltan;
+        p += faltan;
+        bytes -= faltan;
+        if (numPendiente < BYTES_RONDA) {
+            return;
+        }
+        rondaBloque(acumulado, pendiente);
+        numPendiente = 0;
+    }
+
+    for (; bytes >= BYTES_RONDA; bytes -= BYTES_RONDA, p += BYTES_RONDA) {
+        rondaBloque(acumulado, p);
+    }
+    std::memcpy(pendiente, p, bytes);
+    numPendiente = bytes;
+}
+
+quint64 SumaVerificacion::valor() const
+{
+    quint64 suma = GeneradorContador::mezclar(acumulado[0]) ^ GeneradorContador::mezclar(acumulado[1] + 1) ^
+                   GeneradorContador::mezclar(acumulado[2] + 2) ^ GeneradorContador::mezclar(acumulado[3] + 3);
+    for (std::size_t i = 0; i < numPendiente; ++i) {
+        suma = ronda(suma, pendiente[i]);
+    }
+    return GeneradorContador::mezclar(suma ^ total);
+}
+
+quint64 InstantaneaPoblacion::sumaVerificacion(const void* datos, std::size_t bytes)
+{
+    SumaVerificacion suma;
+    suma.agregar(datos, bytes);
+    return suma.valor();
+}
+
+struct EscritorInstantanea::Estado {
+    QString rutaArchivo;
+    QString rutaTemporal;
+    QFile archivo;
+    GrupoHilos& hilos;
+    quint64 filasTotales = 0;
+    quint64 filasEscritas = 0;
+    QByteArray diccionario;
+    std::size_t numLugares = 0;          // Lugares del diccionario
+    QString error;
+    EntradaColumna directorio[NUM_COLUMNAS];
+    SumaVerificacion sumas[NUM_COLUMNAS];
+    quint64 tamanoArchivo = 0;
+    QElapsedTimer cronometro;
+    bool correcto = false;
+
+    Estado(const QString& ruta, quint64 filas, GrupoHilos& grupo)
+        : rutaArchivo(ruta), rutaTemporal(ruta + ".tmp"), archivo(rutaTemporal), hilos(grupo),
+          filasTotales(filas) {}
+};
+
+EscritorInstantanea::EscritorInstantanea(const QString& rutaArchivo, qint64 filasTotales, GrupoHilos* hilos)
+    : estado(std::make_unique<Estado>(rutaArchivo, static_cast<quint64>(std::max<qint64>(0, filasTotales)),
+                                      hilos ? *hilos : GrupoHilos::global()))
+{
+}
+
+EscritorInstantanea::~EscritorInstantanea()
+{
+    // Un escritor abandonado sin cerrar no deja el temporal
+    if (estado->archivo.isOpen()) {
+        estado->archivo.close();
+        QFile::remove(estado->rutaTemporal);
+    }
+}
+
+bool EscritorInstantanea::abrir()
+{
+    Estado& e = *estado;
+    e.cronometro.start();
+
+    QDir dir = QFileInfo(e.rutaArchivo).dir();
+    if (!dir.exists()) {
+        dir.mkpath(".");
+    }
+
+    // Diccionario con el nombre de cada código vigente al abrir
+    QVector<QString> sexos;
+    for (quint8 codigo = SEXO_MASCULINO; codigo <= SEXO_CUALQUIERA; ++codigo) {
+        sexos.append(Catalogo::nombreSexo(codigo));
+    }
+    const QVector<QString> lugares = Catalogo::lugares().nombres();
+    e.numLugares = static_cast<std::size_t>(lugares.size());
+    escribirTabla(e.diccionario, lugares);
+    escribirTabla(e.diccionario, sexos);
+
+    // Directorio: bloques alineados tras la cabecera y el diccionario
+    quint64 posicion = alinear(BYTES_CABECERA + static_cast<quint64>(e.diccionario.size()));
+    for (quint32 c = 0; c < NUM_COLUMNAS; ++c) {
+        e.directorio[c].columna = c;
+        e.directorio[c].ancho = ANCHOS[c];
+        e.directorio[c].inicio = posicion;
+        e.directorio[c].bytes = e.filasTotales * ANCHOS[c];
+        e.directorio[c].suma = 0;
+        posicion = alinear(posicion + e.directorio[c].bytes);
+    }
+    e.tamanoArchivo = posicion;
+
+    // Se escribe aparte y luego se reemplaza: una población podría estar
+    // leyendo el archivo anterior a través de su mapeo
+    e.correcto = e.archivo.open(QIODevice::WriteOnly) &&
+                 e.archivo.resize(static_cast<qint64>(e.tamanoArchivo));
+    return e.correcto;
+}
+
+bool EscritorInstantanea::escribir(const PoblacionColumnar& lote)
+{
+    Estado& e = *estado;
+    const ColumnasPoblacion columnas = lote.obtenerColumnas();
+    if (!e.correcto || e.filasEscritas + columnas.filas > e.filasTotales) {
+        e.correcto = false;
+        return false;
+    }
+    if (columnas.filas > 0 && columnas.maximoCodigoLugar() >= e.numLugares) {
+        e.error = "El lote usa un lugar posterior a la apertura del archivo";
+        e.correcto = false;
+        return false;
+    }
+
+    e.hilos.ejecutar(NUM_COLUMNAS, [&](std::size_t c) {
+        e.sumas[c].agregar(punteroColumna(columnas, static_cast<quint32>(c)), columnas.filas * ANCHOS[c]);
+    });
+
+    for (quint32 c = 0; e.correcto && c < NUM_COLUMNAS; ++c) {
+        const qint64 bytes = static_cast<qint64>(columnas.filas * ANCHOS[c]);
+        e.correcto = e.archivo.seek(static_cast<qint64>(e.directorio[c].inicio + e.filasEscritas * ANCHOS[c])) &&
+                     e.archivo.write(static_cast<const char*>(punteroColumna(columnas, c)), bytes) == bytes;
+    }
+    e.filasEscritas += columnas.filas;
+    return e.correcto;
+}
+
+ResultadoInstantanea EscritorInstantanea::cerrar()
+{
+    Estado& e = *estado;
+    if (e.correcto && e.filasEscritas != e.filasTotales) {
+        e.correcto = false;
+    }
+
+    if (e.correcto) {
+        for (quint32 c = 0; c < NUM_COLUMNAS; ++c) {
+            e.directorio[c].suma = e.sumas[c].valor();
+        }
+
+        Encabezado encabezado;
+        std::memset(&encabezado, 0, sizeof(encabezado));
+        std::memcpy(encabezado.firma, FIRMA, sizeof(FIRMA));
+        encabezado.version = InstantaneaPoblacion::VERSION;
+        encabezado.marcaOrden = MARCA_ORDEN;
+        encabezado.filas = e.filasTotales;
+        encabezado.numColumnas = NUM_COLUMNAS;
+        encabezado.inicioDiccionario = BYTES_CABECERA;
+        encabezado.bytesDiccionario = static_cast<quint64>(e.diccionario.size());
+        encabezado.sumaDiccionario = InstantaneaPoblacion::sumaVerificacion(
+            e.diccionario.constData(), static_cast<std::size_t>(e.diccionario.size()));
+        encabezado.sumaEncabezado = sumaCabecera(encabezado, e.directorio);
+
+        e.correcto = e.archivo.seek(0) &&
+                     e.archivo.write(reinterpret_cast<const char*>(&encabezado), sizeof(encabezado)) ==
+                         static_cast<qint64>(sizeof(encabezado)) &&
+                     e.archivo.write(reinterpret_cast<const char*>(e.directorio), sizeof(e.directorio)) ==
+                         static_cast<qint64>(sizeof(e.directorio)) &&
+                     e.archivo.write(e.diccionario) == e.diccionario.size();
+    }
+    e.archivo.close();
+
+    if (!e.correcto) {
+        QFile::remove(e.rutaTemporal);
+        if (!e.error.isEmpty()) {
+            return fallo(e.error);
+        }
+        return fallo(e.filasEscritas != e.filasTotales ? "Faltan filas" : "Error de escritura");
+    }
+    QFile::remove(e.rutaArchivo);
+    if (!QFile::rename(e.rutaTemporal, e.rutaArchivo)) {
+        QFile::remove(e.rutaTemporal);
+        return fallo("No se pudo reemplazar el archivo");
+    }
+
+    ResultadoInstantanea resultado;
+    resultado.exito = true;
+    resultado.filas = static_cast<qint64>(e.filasTotales);
+    resultado.bytes = static_cast<qint64>(e.tamanoArchivo);
+    resultado.segundos = e.cronometro.nsecsElapsed() / 1e9;
+    return resultado;
+}
+
+ResultadoInstantanea InstantaneaPoblacion::guardar(const QString& rutaArchivo, const PoblacionColumnar& poblacion)
+{
+    EscritorInstantanea escritor(rutaArchivo, static_cast<qint64>(poblacion.tamano()));
+    if (escritor.abrir()) {
+        escritor.escribir(poblacion);
+    }
+    return escritor.cerrar();
+}
+
+bool InstantaneaPoblacion::esInstantanea(const QString& rutaArchivo)
+{
+    QFile archivo(rutaArchivo);
+    if (!archivo.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    QByteArray firma = archivo.read(sizeof(FIRMA));
+    return firma.size() == static_cast<int>(sizeof(FIRMA)) &&
+           std::memcmp(firma.constData(), FIRMA, sizeof(FIRMA)) == 0;
+}
+
+ResultadoInstantanea InstantaneaPoblacion::abrir(const QString& rutaArchivo, PoblacionColumnar& destino,
+                                                 bool verificar)
+{
+    QElapsedTimer cronometro;
+    cronometro.start();
+
+    auto mapeo = std::make_shared<ArchivoMapeado>(rutaArchivo);
+    if (!mapeo->archivo.open(QIODevice::ReadOnly)) {
+        return fallo("No se pudo abrir el archivo");
+    }
+    const qint64 tamano = mapeo->archivo.size();
+    if (tamano < static_cast<qint64>(BYTES_CABECERA)) {
+        return fallo("Archivo truncado");
+    }
+    const char* datos = reinterpret_cast<const char*>(mapeo->archivo.map(0, tamano));
+    if (!datos) {
+        return fallo("No se pudo mapear el archivo");
+    }
+
+    // Encabezado, directorio y diccionario
+    Encabezado encabezado;
+    EntradaColumna directorio[NUM_COLUMNAS];
+    QString motivo = validarCabecera(datos, static_cast<quint64>(tamano), encabezado, directorio);
+    if (!motivo.isEmpty()) {
+        return fallo(motivo);
+    }
+    Traduccion traduccion;
+    if (!leerDiccionario(datos + encabezado.inicioDiccionario, encabezado, traduccion)) {
+        return fallo("Diccionario dañado");
+    }
+    const quint64 filas = encabezado.filas;
+
+    if (verificar) {
+        std::atomic<int> danadas{0};
+        GrupoHilos::global().ejecutar(NUM_COLUMNAS, [&](std::size_t c) {
+            if (sumaVerificacion(datos + directorio[c].inicio, static_cast<std::size_t>(directorio[c].bytes)) !=
+                directorio[c].suma) {
+                danadas.fetch_add(1);
+            }
+        });
+        if (danadas.load() > 0) {
+            return fallo("Columnas dañadas");
+        }
+    }
+
+    // Columnas apuntando al archivo mapeado
+    ColumnasPoblacion columnas;
+    columnas.filas = static_cast<std::size_t>(filas);
+    columnas.id = reinterpret_cast<const qint32*>(datos + directorio[COLUMNA_ID].inicio);
+    columnas.edad = reinterpret_cast<const quint8*>(datos + directorio[COLUMNA_EDAD].inicio);
+    columnas.sexo = reinterpret_cast<const quint8*>(datos + directorio[COLUMNA_SEXO].inicio);
+    columnas.accesoInternet = reinterpret_cast<const quint8*>(datos + directorio[COLUMNA_ACCESO_INTERNET].inicio);
+    columnas.distrito = reinterpret_cast<const quint16*>(datos + directorio[COLUMNA_DISTRITO].inicio);
+    columnas.ubicacion = reinterpret_cast<const quint16*>(datos + directorio[COLUMNA_UBICACION].inicio);
+    columnas.ingresos = reinterpret_cast<const double*>(datos + directorio[COLUMNA_INGRESOS].inicio);
+    columnas.influenciabilidad = reinterpret_cast<const double*>(datos + directorio[COLUMNA_INFLUENCIABILIDAD].inicio);
+    columnas.gasto = reinterpret_cast<const double*>(datos + directorio[COLUMNA_GASTO].inicio);
+
+    // Traducir los códigos solo si el catálogo actual los asigna distinto
+    ResultadoInstantanea resultado;
+    if (!traduccion.lugaresIguales) {
+        columnas.distrito = traducir(columnas.distrito, columnas.filas, traduccion.lugares, mapeo->distritos);
+        columnas.ubicacion = traducir(columnas.ubicacion, columnas.filas, traduccion.lugares, mapeo->ubicaciones);
+        resultado.columnasTraducidas = true;
+    }
+    if (!traduccion.sexosIguales) {
+        columnas.sexo = traducir(columnas.sexo, columnas.filas, traduccion.sexos, mapeo->sexos);
+        resultado.columnasTraducidas = true;
+    }
+
+    destino.adoptarColumnas(columnas, mapeo);
+
+    resultado.exito = true;
+    resultado.filas = static_cast<qint64>(filas);
+    resultado.bytes = tamano;
+    resultado.segundos = cronometro.nsecsElapsed() / 1e9;
+    return resultado;
+}
+
+struct LectorInstantanea::Estado {
+    QFile archivo;
+    Encabezado encabezado;
+    EntradaColumna directorio[NUM_COLUMNAS];
+    Traduccion traduccion;
+    bool verificar = false;
+    SumaVerificacion sumas[NUM_COLUMNAS];
+    quint64 filasLeidas = 0;
+    bool abierto = false;
+    QString error;
+
+    Estado(const QString& ruta, bool verificarSumas) : archivo(ruta), verificar(verificarSumas) {}
+};
+
+LectorInstantanea::LectorInstantanea(const QString& rutaArchivo, bool verificar)
+    : estado(std::make_unique<Estado>(rutaArchivo, verificar))
+{
+}
+
+LectorInstantanea::~LectorInstantanea() = default;
+
+ResultadoInstantanea LectorInstantanea::abrir()
+{
+    Estado& e = *estado;
+    QElapsedTimer cronometro;
+    cronometro.start();
+
+    if (!e.archivo.open(QIODevice::ReadOnly)) {
+        e.error = "No se pudo abrir el archivo";
+        return fallo(e.error);
+    }
+    const qint64 tamano = e.archivo.size();
+    QByteArray cabecera = e.archivo.read(static_cast<qint64>(BYTES_CABECERA));
+    if (cabecera.size() < static_cast<int>(BYTES_CABECERA)) {
+        e.error = "Archivo truncado";
+        return fallo(e.error);
+    }
+    e.error = validarCabecera(cabecera.constData(), static_cast<quint64>(tamano), e.encabezado, e.directorio);
+    if (!e.error.isEmpty()) {
+        return fallo(e.error);
+    }
+
+    QByteArray diccionario;
+    if (e.archivo.seek(static_cast<qint64>(e.encabezado.inicioDiccionario))) {
+        diccionario = e.archivo.read(static_cast<qint64>(e.encabezado.bytesDiccionario));
+    }
+    if (static_cast<quint64>(diccionario.size()) != e.encabezado.bytesDiccionario ||
+        !leerDiccionario(diccionario.constData(), e.encabezado, e.traduccion)) {
+        e.error = "Diccionario dañado";
+        return fallo(e.error);
+    }
+    e.abierto = true;
+
+    ResultadoInstantanea resultado;
+    resultado.exito = true;
+    resultado.filas = static_cast<qint64>(e.encabezado.filas);
+    resultado.bytes = tamano;
+    resultado.columnasTraducidas = !e.traduccion.lugaresIguales || !e.traduccion.sexosIguales;
+    resultado.segundos = cronometro.nsecsElapsed() / 1e9;
+    return resultado;
+}
+
+qint64 LectorInstantanea::filas() const
+{
+    return estado->abierto ? static_cast<qint64>(estado->encabezado.filas) : 0;
+}
+
+qint64 LectorInstantanea::filasLeidas() const
+{
+    return static_cast<qint64>(estado->filasLeidas);
+}
+
+QString LectorInstantanea::error() const
+{
+    return estado->error;
+}
+
+bool LectorInstantanea::leer(PoblacionColumnar& lote, std::size_t maximo)
+{
+    Estado& e = *estado;
+    if (!e.abierto || !e.error.isEmpty()) {
+        return false;
+    }
+    const quint64 filas = std::min<quint64>(maximo, e.encabezado.filas - e.filasLeidas);
+    if (filas == 0) {
+        lote.limpiar();
+        return false;
+    }
+
+    // Cada columna es un bloque contiguo: una lectura por columna
+    lote.redimensionar(static_cast<std::size_t>(filas));
+    const ColumnasEscritura columnas = lote.obtenerColumnasEscritura();
+    for (quint32 c = 0; c < NUM_COLUMNAS; ++c) {
+        const qint64 bytes = static_cast<qint64>(filas * ANCHOS[c]);
+        char* destino = static_cast<char*>(punteroColumna(columnas, c));
+        if (!e.archivo.seek(static_cast<qint64>(e.directorio[c].inicio + e.filasLeidas * ANCHOS[c])) ||
+            e.archivo.read(destino, bytes) != bytes) {
+            e.error = "Error de lectura";
+            lote.limpiar();
+            return false;
+        }
+        if (e.verificar) {
+            e.sumas[c].agregar(destino, static_cast<std::size_t>(bytes));
+        }
+    }
+    e.filasLeidas += filas;
+
+    if (e.verificar && e.filasLeidas == e.encabezado.filas) {
+        for (quint32 c = 0; c < NUM_COLUMNAS; ++c) {
+            if (e.sumas[c].valor() != e.directorio[c].suma) {
+                e.error = "Columnas dañadas";
+                lote.limpiar();
+                return false;
+            }
+        }
+    }
+
+    if (!e.traduccion.lugaresIguales) {
+        traducir(columnas.distrito, columnas.distrito, columnas.filas, e.traduccion.lugares);
+        traducir(columnas.ubicacion, columnas.ubicacion, columnas.filas, e.traduccion.lugares);
+    }
+    if (!e.traduccion.sexosIguales) {
+        traducir(columnas.sexo, columnas.sexo, columnas.filas, e.traduccion.sexos);
+    }
+    return true;
+}
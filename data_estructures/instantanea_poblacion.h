@@ -0,0 +1,127 @@
+#ifndef INSTANTANEA_POBLACION_H
+#define INSTANTANEA_POBLACION_H
+
+#include "poblacion_columnar.h"
+#include <QString>
+#include <cstddef>
+#include <memory>
+
+class GrupoHilos;
+
+// Resultado de guardar o abrir una instantánea
+struct ResultadoInstantanea {
+    bool exito = false;
+    QString error;                       // Motivo del fallo, vacío si exito
+    qint64 filas = 0;
+    qint64 bytes = 0;
+    bool columnasTraducidas = false;     // Los códigos del archivo no coincidían con el catálogo
+    double segundos = 0.0;
+};
+
+// Instantánea binaria por columnas de una población.
+//
+// Formato (little-endian, versión 1):
+//   - Encabezado de 64 bytes con firma, versión, filas y suma del encabezado
+//   - Directorio con una entrada por columna: ancho, posición, bytes y suma
+//   - Diccionario de lugares y sexos: nombre de cada código usado al guardar
+//   - Bloques de columnas alineados a 64 bytes
+//
+// Al abrir, el archivo se mapea y la población apunta directamente a los
+// bloques, sin copiarlos. Si los códigos del diccionario no coinciden con
+// el catálogo actual, solo se traducen las columnas categóricas afectadas.
+class InstantaneaPoblacion
+{
+public:
+    static constexpr quint32 VERSION = 1;
+    static constexpr std::size_t ALINEACION = 64;
+
+    static ResultadoInstantanea guardar(const QString& rutaArchivo, const PoblacionColumnar& poblacion);
+
+    // verificar: comprueba además la suma de cada columna (recorre todo el archivo)
+    static ResultadoInstantanea abrir(const QString& rutaArchivo, PoblacionColumnar& destino,
+                                      bool verificar = false);
+
+    // Comprueba solo la firma del archivo
+    static bool esInstantanea(const QString& rutaArchivo);
+
+    // Suma de verificación de 64 bits sobre palabras de 8 bytes
+    static quint64 sumaVerificacion(const void* datos, std::size_t bytes);
+};
+
+// Suma de verificación calculada por partes: da el mismo valor que
+// InstantaneaPoblacion::sumaVerificacion sobre los datos concatenados
+class SumaVerificacion
+{
+public:
+    SumaVerificacion();
+
+    void agregar(const void* datos, std::size_t bytes);
+    quint64 valor() const;
+
+private:
+    quint64 acumulado[4];
+    unsigned char pendiente[32];         // Bytes que aún no completan un bloque
+    std::size_t numPendiente = 0;
+    quint64 total = 0;
+};
+
+// Escritura de una instantánea por lotes, sin tener la población entera en
+// memoria. Las filas totales se fijan al abrir: cada columna ocupa su bloque
+// definitivo y cada lote se escribe en su posición. El encabezado con las
+// sumas se escribe al cerrar y el archivo se publica con un renombrado.
+// Las sumas de cada lote se calculan en hilos (nullptr = GrupoHilos::global());
+// igual que en EscritorCSV, un escritor que corre junto al generador necesita
+// un grupo propio.
+class EscritorInstantanea
+{
+public:
+    EscritorInstantanea(const QString& rutaArchivo, qint64 filasTotales, GrupoHilos* hilos = nullptr);
+    ~EscritorInstantanea();
+
+    EscritorInstantanea(const EscritorInstantanea&) = delete;
+    EscritorInstantanea& operator=(const EscritorInstantanea&) = delete;
+
+    bool abrir();
+
+    // Falla si el lote usa un lugar internado después de abrir(): el
+    // diccionario del archivo ya quedó fijado
+    bool escribir(const PoblacionColumnar& lote);
+
+    // Falla si no se escribieron exactamente las filas anunciadas
+    ResultadoInstantanea cerrar();
+
+private:
+    struct Estado;
+    std::unique_ptr<Estado> estado;
+};
+
+// Lectura de una instantánea por lotes, sin mapearla entera: cada lote lee
+// el tramo siguiente de cada columna y traduce sus códigos al catálogo
+// actual. Con verificar, las sumas de las columnas se comprueban al leer
+// la última fila.
+class LectorInstantanea
+{
+public:
+    explicit LectorInstantanea(const QString& rutaArchivo, bool verificar = false);
+    ~LectorInstantanea();
+
+    LectorInstantanea(const LectorInstantanea&) = delete;
+    LectorInstantanea& operator=(const LectorInstantanea&) = delete;
+
+    // Valida encabezado, directorio y diccionario
+    ResultadoInstantanea abrir();
+
+    qint64 filas() const;
+    qint64 filasLeidas() const;
+    QString error() const;               // Vacío mientras no haya fallos
+
+    // Reemplaza el contenido de lote con hasta maximo filas siguientes.
+    // Devuelve false al terminar o ante un error.
+    bool leer(PoblacionColumnar& lote, std::size_t maximo);
+
+private:
+    struct Estado;
+    std::unique_ptr<Estado> estado;
+};
+
+#endif // INSTANTANEA_POBLACION_H
@@ -0,0 +1,324 @@
+#include "lector_csv.h"
+#include "esquema_csv.h"
+#include "generador_aleatorio.h"
+#include "../system/grupo_hilos.h"
+#include <QFile>
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <cstring>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+// Tramo del archivo [inicio, fin); termina justo después de un salto de línea
+// o al final del archivo
+struct Tramo {
+    const char* inicio = nullptr;
+    const char* fin = nullptr;
+    std::size_t primeraLinea = 0;        // Índice de su primera línea en el texto (= primera fila reservada)
+    std::size_t lineas = 0;              // Cota superior de filas del tramo
+    std::size_t filas = 0;               // Filas válidas escritas
+    qint64 malformadas = 0;
+    qint64 invalidos = 0;
+};
+
+inline bool esEspacio(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+inline std::string_view recortar(const char* inicio, const char* fin)
+{
+    while (inicio < fin && esEspacio(*inicio)) ++inicio;
+    while (fin > inicio && esEspacio(fin[-1])) --fin;
+    return std::string_view(inicio, static_cast<std::size_t>(fin - inicio));
+}
+
+// Número completo o 0 si el campo no es legible (como QString::toInt/toDouble)
+template <typename T>
+inline T leerNumero(std::string_view campo, qint64& invalidos)
+{
+    const char* inicio = campo.data();
+    const char* fin = inicio + campo.size();
+    if (inicio < fin && *inicio == '+') {
+        ++inicio;
+    }
+
+    T valor{};
+    auto [ptr, ec] = std::from_chars(inicio, fin, valor);
+    if (ec != std::errc() || ptr != fin || inicio == fin) {
+        ++invalidos;
+        return T{};
+    }
+    return valor;
+}
+
+// Equivalente a Catalogo::codificarSexo sin crear un QString
+inline quint8 codificarSexo(std::string_view sexo)
+{
+    if (sexo == "Masculino") return SEXO_MASCULINO;
+    if (sexo == "Femenino") return SEXO_FEMENINO;
+    if (sexo == "Cualquiera") return SEXO_CUALQUIERA;
+    return SEXO_DESCONOCIDO;
+}
+
+// Caché local de códigos de lugar. Las claves apuntan al archivo mapeado,
+// así que solo el primer encuentro de cada nombre toca el catálogo global.
+class CacheLugares
+{
+public:
+    quint16 codigo(std::string_view nombre)
+    {
+        auto it = codigos.find(nombre);
+        if (it != codigos.end()) {
+            return it->second;
+        }
+        quint16 codigo = Catalogo::lugares().internar(
+            QString::fromUtf8(nombre.data(), static_cast<int>(nombre.size())));
+        codigos.emplace(nombre, codigo);
+        return codigo;
+    }
+
+private:
+    std::unordered_map<std::string_view, quint16> codigos;
+};
+
+std::size_t contarLineas(const char* inicio, const char* fin)
+{
+    if (inicio == fin) {
+        return 0;
+    }
+    std::size_t saltos = static_cast<std::size_t>(std::count(inicio, fin, '\n'));
+    return saltos + (fin[-1] != '\n' ? 1 : 0);
+}
+
+void analizarTramo(Tramo& tramo, const EsquemaCSV& esquema, PoblacionColumnar& destino, quint64 semilla,
+                   quint64 primeraLinea)
+{
+    static const EsquemaCSV completo = EsquemaCSV::completo();
+    CacheLugares lugares;
+    std::string_view campos[EsquemaCSV::MAX_COLUMNAS];
+    std::size_t linea = tramo.primeraLinea;
+
+    for (const char* p = tramo.inicio; p < tramo.fin; ++linea) {
+        const char* salto = static_cast<const char*>(std::memchr(p, '\n', tramo.fin - p));
+        const char* finLinea = salto ? salto : tramo.fin;
+        std::string_view texto = recortar(p, finLinea);
+        p = finLinea + 1;
+
+        if (texto.empty()) {
+            continue;
+        }
+
+        // Separar hasta MAX_COLUMNAS columnas; las sobrantes se ignoran
+        int numCampos = 0;
+        const char* inicioCampo = texto.data();
+        const char* finTexto = texto.data() + texto.size();
+        while (numCampos < EsquemaCSV::MAX_COLUMNAS) {
+            const char* coma = static_cast<const char*>(std::memchr(inicioCampo, ',', finTexto - inicioCampo));
+            const char* finCampo = coma ? coma : finTexto;
+            campos[numCampos++] = recortar(inicioCampo, finCampo);
+            if (!coma) {
+                break;
+            }
+            inicioCampo = coma + 1;
+        }
+
+        const EsquemaCSV& e = (esquema.admiteFilasCompletas && numCampos == NUM_CAMPOS_CSV) ? completo : esquema;
+        if (numCampos < e.columnasMinimas) {
+            tramo.malformadas++;
+            continue;
+        }
+        auto campo = [&](CampoCSV c) -> const std::string_view* {
+            int k = e.columna[c];
+            return (k >= 0 && k < numCampos) ? &campos[k] : nullptr;
+        };
+
+        const std::string_view* id = esquema.tiene(CAMPO_ID) ? campo(CAMPO_ID) : nullptr;
+        int edad = leerNumero<int>(*campo(CAMPO_EDAD), tramo.invalidos);
+        quint8 sexo = codificarSexo(*campo(CAMPO_SEXO));
+        bool accesoInternet = leerNumero<int>(*campo(CAMPO_ACCESO_INTERNET), tramo.invalidos) == 1;
+        quint16 distrito = lugares.codigo(*campo(CAMPO_DISTRITO));
+
+        // Campos opcionales: si faltan se sortean con la línea como clave
+        const quint64 clave = primeraLinea + static_cast<quint64>(linea);
+        const std::string_view* ingresos = campo(CAMPO_INGRESOS);
+        const std::string_view* ubicacion = campo(CAMPO_UBICACION);
+        const std::string_view* influenciabilidad = campo(CAMPO_INFLUENCIABILIDAD);
+        const std::string_view* gasto = campo(CAMPO_GASTO);
+
+        // Sin columna Id los ids se numeran al compactar
+        destino.establecerFila(tramo.primeraLinea + tramo.filas,
+            id ? leerNumero<qint32>(*id, tramo.invalidos) : 0,
+            static_cast<quint8>(std::clamp(edad, 0, PoblacionColumnar::EDAD_MAXIMA)),
+            sexo, accesoInternet, distrito,
+            (ubicacion && !ubicacion->empty()) ? lugares.codigo(*ubicacion) : distrito,
+            ingresos ? leerNumero<double>(*ingresos, tramo.invalidos) :
+                25000 + GeneradorContador::uniforme(semilla, clave, GeneradorContador::FLUJO_INGRESOS) * 75000,
+            influenciabilidad ? leerNumero<double>(*influenciabilidad, tramo.invalidos) :
+                0.2 + GeneradorContador::uniforme(semilla, clave, GeneradorContador::FLUJO_INFLUENCIABILIDAD) * 0.8,
+            gasto ? leerNumero<double>(*gasto, tramo.invalidos) :
+                150 + GeneradorContador::uniforme(semilla, clave, GeneradorContador::FLUJO_GASTO) * 1850);
+        tramo.filas++;
+    }
+}
+
+} // namespace
+
+EstadisticasLectura LectorCSV::cargar(const QString& rutaArchivo,
+                                      PoblacionColumnar& destino,
+                                      quint64 semilla,
+                                      const FuncionProgreso& progreso,
+                                      const std::atomic<bool>* cancelado)
+{
+    EstadisticasLectura estadisticas;
+    QElapsedTimer cronometro;
+    cronometro.start();
+
+    QFile archivo(rutaArchivo);
+    if (!archivo.open(QIODevice::ReadOnly)) {
+        return estadisticas;
+    }
+    estadisticas.exito = true;
+    destino.limpiar();
+
+    // Mapear el archivo; si no se puede (p. ej. recursos Qt), leerlo a memoria
+    const qint64 tamano = archivo.size();
+    QByteArray copia;
+    const char* datos = nullptr;
+    qint64 bytes = 0;
+    if (tamano > 0) {
+        datos = reinterpret_cast<const char*>(archivo.map(0, tamano));
+        bytes = tamano;
+    }
+    if (!datos) {
+        copia = archivo.readAll();
+        datos = copia.constData();
+        bytes = copia.size();
+    }
+    const char* finDatos = datos + bytes;
+    estadisticas.bytes = bytes;
+
+    EsquemaCSV esquema;
+    const char* inicio = leerEncabezado(datos, finDatos, esquema);
+
+    EstadisticasLectura texto = analizarTexto(inicio, finDatos, esquema, destino, semilla, 0, 1, progreso,
+                                              nullptr, cancelado);
+    estadisticas.exito = texto.exito;
+    estadisticas.filas = texto.filas;
+    estadisticas.lineas = texto.lineas;
+    estadisticas.lineasMalformadas = texto.lineasMalformadas;
+    estadisticas.camposInvalidos = texto.camposInvalidos;
+    estadisticas.segundos = cronometro.nsecsElapsed() / 1e9;
+    return estadisticas;
+}
+
+const char* LectorCSV::leerEncabezado(const char* inicio, const char* fin, EsquemaCSV& esquema)
+{
+    // La primera línea es encabezado si no empieza con un dígito; si no
+    // nombra los campos obligatorios se usa el orden posicional
+    esquema = EsquemaCSV::posicional();
+    if (inicio < fin && !(*inicio >= '0' && *inicio <= '9')) {
+        const char* salto = static_cast<const char*>(std::memchr(inicio, '\n', fin - inicio));
+        const char* finEncabezado = salto ? salto : fin;
+        if (!EsquemaCSV::desdeEncabezado(std::string_view(inicio, static_cast<std::size_t>(finEncabezado - inicio)),
+                                         esquema)) {
+            esquema = EsquemaCSV::posicional();
+        }
+        inicio = salto ? salto + 1 : fin;
+    }
+    return inicio;
+}
+
+EstadisticasLectura LectorCSV::analizarTexto(const char* inicio, const char* finDatos,
+                                             const EsquemaCSV& esquema,
+                                             PoblacionColumnar& destino,
+                                             quint64 semilla,
+                                             quint64 primeraLinea,
+                                             qint64 primerId,
+                                             const FuncionProgreso& progreso,
+                                             GrupoHilos* grupo,
+                                             const std::atomic<bool>* cancelado)
+{
+    EstadisticasLectura estadisticas;
+    estadisticas.exito = true;
+    estadisticas.bytes = finDatos - inicio;
+    destino.limpiar();
+
+    // Dividir en tramos que terminan en salto de línea
+    std::vector<Tramo> tramos;
+    for (const char* p = inicio; p < finDatos; ) {
+        const char* corte = (finDatos - p > TAMANO_TRAMO) ? p + TAMANO_TRAMO : finDatos;
+        if (corte < finDatos) {
+            const char* salto = static_cast<const char*>(std::memchr(corte, '\n', finDatos - corte));
+            corte = salto ? salto + 1 : finDatos;
+        }
+        Tramo tramo;
+        tramo.inicio = p;
+        tramo.fin = corte;
+        tramos.push_back(tramo);
+        p = corte;
+    }
+
+    // Primera pasada: contar líneas para reservar a cada tramo sus filas
+    GrupoHilos& hilos = grupo ? *grupo : GrupoHilos::global();
+    hilos.ejecutar(tramos.size(), [&](std::size_t i) {
+        tramos[i].lineas = contarLineas(tramos[i].inicio, tramos[i].fin);
+    });
+
+    std::size_t totalLineas = 0;
+    for (Tramo& tramo : tramos) {
+        tramo.primeraLinea = totalLineas;
+        totalLineas += tramo.lineas;
+    }
+    destino.redimensionar(totalLineas);
+    estadisticas.lineas = static_cast<qint64>(totalLineas);
+
+    // Segunda pasada: cada tramo escribe en su propio rango de filas
+    std::atomic<std::size_t> tramosHechos{0};
+    hilos.ejecutar(tramos.size(), [&](std::size_t i) {
+        if (cancelado && cancelado->load(std::memory_order_relaxed)) {
+            return;
+        }
+        analizarTramo(tramos[i], esquema, destino, semilla, primeraLinea);
+
+        std::size_t hechos = tramosHechos.fetch_add(1) + 1;
+        if (progreso) {
+            progreso(static_cast<int>(hechos * 100 / tramos.size()));
+        }
+    });
+
+    // Una lectura cancelada deja tramos sin analizar: no se entrega a medias
+    if (cancelado && cancelado->load()) {
+        destino.limpiar();
+        estadisticas.exito = false;
+        return estadisticas;
+    }
+
+    // Compactar los huecos de líneas vacías o malformadas
+    std::size_t filas = 0;
+    for (const Tramo& tramo : tramos) {
+        destino.moverFilas(tramo.primeraLinea, filas, tramo.filas);
+        filas += tramo.filas;
+        estadisticas.lineasMalformadas += tramo.malformadas;
+        estadisticas.camposInvalidos += tramo.invalidos;
+    }
+    destino.redimensionar(filas);
+    if (!esquema.tiene(CAMPO_ID)) {
+        for (std::size_t fila = 0; fila < filas; ++fila) {
+            destino.establecerId(fila, static_cast<qint32>(primerId + static_cast<qint64>(fila)));
+        }
+    }
+
+    if (progreso && tramos.empty()) {
+        progreso(100);
+    }
+
+    estadisticas.filas = static_cast<qint64>(filas);
+    return estadisticas;
+}
@@ -0,0 +1,71 @@
+#ifndef LECTOR_CSV_H
+#define LECTOR_CSV_H
+
+#include "poblacion_columnar.h"
+#include "esquema_csv.h"
+#include <QString>
+#include <atomic>
+#include <functional>
+
+class GrupoHilos;
+
+// Resultado de una lectura de población desde CSV
+struct EstadisticasLectura {
+    bool exito = false;                  // false si el archivo no pudo abrirse o se canceló
+    qint64 filas = 0;                    // Personas cargadas
+    qint64 lineas = 0;                   // Líneas examinadas, sin contar el encabezado
+    qint64 lineasMalformadas = 0;        // Líneas descartadas (faltan campos obligatorios)
+    qint64 camposInvalidos = 0;          // Campos numéricos ilegibles (se cargan como 0)
+    qint64 bytes = 0;
+    double segundos = 0.0;
+
+    double filasPorSegundo() const { return segundos > 0.0 ? filas / segundos : 0.0; }
+};
+
+// Lector de CSV de población de alto rendimiento.
+// Mapea el archivo en memoria, lo divide en tramos que terminan en salto de
+// línea y los analiza en paralelo sin crear QString por campo: los números
+// se leen con std::from_chars y los distritos se resuelven al catálogo con
+// una caché por tramo. Cada tramo escribe sus filas directamente en la
+// población destino.
+//
+// Las columnas se ubican según el encabezado (ver EsquemaCSV). Sin
+// encabezado se usa el orden posicional Edad,Sexo,AccesoInternet,Distrito
+// y, opcionalmente, Ingresos,Ubicacion,Influenciabilidad,Gasto. Sin columna
+// Id los ids son secuenciales; los campos opcionales ausentes se sortean
+// con semilla.
+class LectorCSV
+{
+public:
+    using FuncionProgreso = std::function<void(int porcentaje)>;
+
+    // Tamaño aproximado de cada tramo analizado por un hilo
+    static constexpr qint64 TAMANO_TRAMO = 4 * 1024 * 1024;
+
+    // Si cancelado se activa, deja de analizar tramos y destino queda vacío
+    static EstadisticasLectura cargar(const QString& rutaArchivo,
+                                      PoblacionColumnar& destino,
+                                      quint64 semilla,
+                                      const FuncionProgreso& progreso = nullptr,
+                                      const std::atomic<bool>* cancelado = nullptr);
+
+    // Lee el encabezado, si lo hay, y devuelve dónde empiezan los datos
+    static const char* leerEncabezado(const char* inicio, const char* fin, EsquemaCSV& esquema);
+
+    // Analiza líneas completas [inicio, fin) y reemplaza el contenido de destino.
+    // primeraLinea es el índice de la primera línea dentro del archivo (clave de
+    // los sorteos) y primerId el id de la primera fila cuando no hay columna Id;
+    // así un archivo leído por partes da lo mismo que leído de una vez.
+    // Los tramos se analizan en hilos (nullptr = GrupoHilos::global()).
+    static EstadisticasLectura analizarTexto(const char* inicio, const char* fin,
+                                             const EsquemaCSV& esquema,
+                                             PoblacionColumnar& destino,
+                                             quint64 semilla,
+                                             quint64 primeraLinea = 0,
+                                             qint64 primerId = 1,
+                                             const FuncionProgreso& progreso = nullptr,
+                                             GrupoHilos* hilos = nullptr,
+                                             const std::atomic<bool>* cancelado = nullptr);
+};
+
+#endif // LECTOR_CSV_H
@@ -2,25 +2,49 @@
 #define PERSONA_H
 
 #include <QString>
+#include "catalogo.h"
 
-// Estructura para representar una persona
+// Estructura para representar una persona.
+// Los campos categóricos guardan códigos del Catalogo en lugar de textos.
 struct Persona {
     int id;                              // ID único de la persona
     int edad;                            // Edad de la persona
-    QString sexo;                        // Sexo: "Masculino" o "Femenino"
+    quint16 distrito;                    // Distrito/ubicación geográfica (Catalogo::lugares)
+    quint16 ubicacion;                   // Ubicación general (puede ser igual a distrito)
+    quint8 sexo;                         // CodigoSexo: masculino o femenino
     bool accesoInternet;                 // Acceso a internet
-    QString distrito;                    // Distrito/ubicación geográfica
     
     // Nuevos campos para el modelo de uplift
     double ingresos;                     // Ingresos anuales
-    QString ubicacion;                   // Ubicación general (puede ser igual a distrito)
     double influenciabilidad_digital;   // Factor de influenciabilidad digital (0.0-1.0)
     double gasto_promedio;              // Gasto promedio mensual
     
+    // El lugar vacío usa el código reservado sin pasar por el candado del catálogo
     Persona(int i = 0, int e = 0, const QString& s = "", bool ai = false, const QString& d = "",
             double ing = 30000.0, const QString& ub = "", double inf_dig = 0.5, double gasto = 300.0) 
-        : id(i), edad(e), sexo(s), accesoInternet(ai), distrito(d), 
-          ingresos(ing), ubicacion(ub.isEmpty() ? d : ub), influenciabilidad_digital(inf_dig), gasto_promedio(gasto) {}
+        : id(i), edad(e), distrito(d.isEmpty() ? Catalogo::SIN_NOMBRE : Catalogo::lugares().internar(d)),
+          ubicacion(ub.isEmpty() ? distrito : Catalogo::lugares().internar(ub)),
+          sexo(Catalogo::codificarSexo(s)), accesoInternet(ai),
+          ingresos(ing), influenciabilidad_digital(inf_dig), gasto_promedio(gasto) {}
+    
+    // Construye una persona a partir de códigos ya internados
+    static Persona desdeCodigos(int i, int e, quint8 s, bool ai, quint16 d,
+                                double ing, quint16 ub, double inf_dig, double gasto) {
+        Persona persona(i, e);
+        persona.sexo = s;
+        persona.accesoInternet = ai;
+        persona.distrito = d;
+        persona.ubicacion = ub;
+        persona.ingresos = ing;
+        persona.influenciabilidad_digital = inf_dig;
+        persona.gasto_promedio = gasto;
+        return persona;
+    }
+    
+    // Nombres legibles de los campos categóricos
+    QString nombreSexo() const { return Catalogo::nombreSexo(sexo); }
+    QString nombreDistrito() const { return Catalogo::lugares().nombre(distrito); }
+    QString nombreUbicacion() const { return Catalogo::lugares().nombre(ubicacion); }
     
     // Métodos para comparación y conversión
     bool operator==(const Persona& other) const {
@@ -30,8 +54,8 @@ struct Persona {
     
     QString toString() const {
         return QString("%1,%2,%3,%4,%5,%6,%7,%8,%9")
-            .arg(id).arg(edad).arg(sexo).arg(accesoInternet ? 1 : 0)
-            .arg(distrito).arg(ingresos).arg(ubicacion)
+            .arg(id).arg(edad).arg(nombreSexo()).arg(accesoInternet ? 1 : 0)
+            .arg(nombreDistrito()).arg(ingresos).arg(nombreUbicacion())
             .arg(influenciabilidad_digital).arg(gasto_promedio);
     }
 };
@@ -40,15 +64,17 @@ struct Persona {
 struct ClienteIdeal {
     int edadMin;
     int edadMax;
-    QString sexo;
+    quint8 sexo;                         // CodigoSexo; SEXO_CUALQUIERA no filtra
     bool requiereInternet;
     
     ClienteIdeal(int eMin = 18, int eMax = 65, const QString& s = "Cualquiera", bool ri = true)
-        : edadMin(eMin), edadMax(eMax), sexo(s), requiereInternet(ri) {}
+        : edadMin(eMin), edadMax(eMax), sexo(Catalogo::codificarSexo(s)), requiereInternet(ri) {}
+    
+    QString nombreSexo() const { return Catalogo::nombreSexo(sexo); }
     
     bool cumpleRequisitos(const Persona& persona) const {
         if (persona.edad < edadMin || persona.edad > edadMax) return false;
-        if (sexo != "Cualquiera" && persona.sexo != sexo) return false;
+        if (sexo != SEXO_CUALQUIERA && persona.sexo != sexo) return false;
         if (requiereInternet && !persona.accesoInternet) return false;
         return true;
     }
@@ -68,4 +94,54 @@ struct ResultadoAnalisis {
         : clientesPotenciales(cp), espacio(e), producto(p), tipoEspacio(te), clienteIdeal(ci) {}
 };
 
+// Estimación analítica del tráfico: valor esperado sin muestreo y su incertidumbre
+struct EstimacionTrafico {
+    double esperado;                     // Suma de probabilidades finales
+    double varianza;                     // Suma de p * (1 - p)
+    double limiteInferior;               // Intervalo de confianza (aproximación normal)
+    double limiteSuperior;
+    double nivelConfianza;
+    qint64 personasElegibles;            // Personas con probabilidad final mayor que cero
+    
+    EstimacionTrafico(double esp = 0.0, double var = 0.0, double inf = 0.0, double sup = 0.0,
+                      double nivel = 0.95, qint64 elegibles = 0)
+        : esperado(esp), varianza(var), limiteInferior(inf), limiteSuperior(sup),
+          nivelConfianza(nivel), personasElegibles(elegibles) {}
+};
+
+// Un escenario de una comparación por lotes: la misma consulta que recibe
+// calcularTraficoConUplift
+struct EscenarioTrafico {
+    ClienteIdeal cliente;
+    QString espacio;
+    QString producto;
+    QString tipoEspacio;
+    double umbralInfluenciabilidad;
+    
+    EscenarioTrafico(const ClienteIdeal& ci = ClienteIdeal(), const QString& e = "",
+                     const QString& p = "", const QString& te = "", double umbral = 0.5)
+        : cliente(ci), espacio(e), producto(p), tipoEspacio(te), umbralInfluenciabilidad(umbral) {}
+};
+
+// Resultado de un escenario en los tres modos del análisis
+struct ResultadoEscenario {
+    static constexpr int SIN_MUESTREO = -1;
+    
+    int trafico;                         // Personas que cumplen los criterios de inclusión
+    int traficoConUplift;                // Conversiones sorteadas, o SIN_MUESTREO
+    EstimacionTrafico estimacion;        // Valor esperado e intervalo
+    
+    ResultadoEscenario() : trafico(0), traficoConUplift(0) {}
+};
+
+// Un punto de la curva de alcance: el resultado con un umbral de uplift dado
+struct PuntoAlcance {
+    double umbral;
+    int traficoConUplift;                // Conversiones sorteadas
+    EstimacionTrafico estimacion;        // Valor esperado e intervalo
+    
+    PuntoAlcance(double u = 0.0, int trafico = 0, const EstimacionTrafico& e = EstimacionTrafico())
+        : umbral(u), traficoConUplift(trafico), estimacion(e) {}
+};
+
 #endif // PERSONA_H
@@ -0,0 +1,210 @@
+#include "poblacion_columnar.h"
+#include "../system/grupo_hilos.h"
+#include <algorithm>
+
+void PoblacionColumnar::reservar(std::size_t capacidad)
+{
+    materializar();
+    ids.reserve(capacidad);
+    edades.reserve(capacidad);
+    sexos.reserve(capacidad);
+    accesosInternet.reserve(capacidad);
+    distritos.reserve(capacidad);
+    ubicaciones.reserve(capacidad);
+    ingresos.reserve(capacidad);
+    influenciabilidades.reserve(capacidad);
+    gastos.reserve(capacidad);
+}
+
+void PoblacionColumnar::limpiar()
+{
+    respaldo.reset();
+    externas = ColumnasPoblacion();
+    ids.clear();
+    edades.clear();
+    sexos.clear();
+    accesosInternet.clear();
+    distritos.clear();
+    ubicaciones.clear();
+    ingresos.clear();
+    influenciabilidades.clear();
+    gastos.clear();
+}
+
+void PoblacionColumnar::redimensionar(std::size_t filas)
+{
+    materializar();
+    ids.resize(filas);
+    edades.resize(filas);
+    sexos.resize(filas);
+    accesosInternet.resize(filas);
+    distritos.resize(filas);
+    ubicaciones.resize(filas);
+    ingresos.resize(filas);
+    influenciabilidades.resize(filas);
+    gastos.resize(filas);
+}
+
+void PoblacionColumnar::agregar(const Persona& persona)
+{
+    materializar();
+    ids.push_back(persona.id);
+    edades.push_back(static_cast<quint8>(std::clamp(persona.edad, 0, EDAD_MAXIMA)));
+    sexos.push_back(persona.sexo);
+    accesosInternet.push_back(persona.accesoInternet ? 1 : 0);
+    distritos.push_back(persona.distrito);
+    ubicaciones.push_back(persona.ubicacion);
+    ingresos.push_back(persona.ingresos);
+    influenciabilidades.push_back(persona.influenciabilidad_digital);
+    gastos.push_back(persona.gasto_promedio);
+}
+
+void PoblacionColumnar::establecerFila(std::size_t fila, qint32 id, quint8 edad, quint8 sexo,
+                                       bool accesoInternet, quint16 distrito, quint16 ubicacion,
+                                       double ingreso, double influenciabilidad, double gasto)
+{
+    ids[fila] = id;
+    edades[fila] = edad;
+    sexos[fila] = sexo;
+    accesosInternet[fila] = accesoInternet ? 1 : 0;
+    distritos[fila] = distrito;
+    ubicaciones[fila] = ubicacion;
+    ingresos[fila] = ingreso;
+    influenciabilidades[fila] = influenciabilidad;
+    gastos[fila] = gasto;
+}
+
+void PoblacionColumnar::moverFilas(std::size_t desde, std::size_t hacia, std::size_t cantidad)
+{
+    if (desde == hacia || cantidad == 0) {
+        return;
+    }
+    
+    auto mover = [&](auto& columna) {
+        std::copy(columna.begin() + desde, columna.begin() + desde + cantidad, columna.begin() + hacia);
+    };
+    mover(ids);
+    mover(edades);
+    mover(sexos);
+    mover(accesosInternet);
+    mover(distritos);
+    mover(ubicaciones);
+    mover(ingresos);
+    mover(influenciabilidades);
+    mover(gastos);
+}
+
+void PoblacionColumnar::reunirFilas(const ColumnasPoblacion& origen, const quint32* filas, std::size_t cantidad)
+{
+    static constexpr std::size_t FILAS_POR_BLOQUE = 65536;
+    respaldo.reset();
+    externas = ColumnasPoblacion();
+    redimensionar(cantidad);
+    const std::size_t numBloques = (cantidad + FILAS_POR_BLOQUE - 1) / FILAS_POR_BLOQUE;
+    
+    // Cada bloque copia sus filas columna por columna
+    GrupoHilos::global().ejecutar(numBloques, [&](std::size_t bloque) {
+        const std::size_t inicio = bloque * FILAS_POR_BLOQUE;
+        const std::size_t fin = std::min(inicio + FILAS_POR_BLOQUE, cantidad);
+        auto reunir = [&](const auto* desde, auto& columna) {
+            for (std::size_t i = inicio; i < fin; ++i) {
+                columna[i] = desde[filas[i]];
+            }
+        };
+        reunir(origen.id, ids);
+        reunir(origen.edad, edades);
+        reunir(origen.sexo, sexos);
+        reunir(origen.accesoInternet, accesosInternet);
+        reunir(origen.distrito, distritos);
+        reunir(origen.ubicacion, ubicaciones);
+        reunir(origen.ingresos, ingresos);
+        reunir(origen.influenciabilidad, influenciabilidades);
+        reunir(origen.gasto, gastos);
+    });
+}
+
+Persona PoblacionColumnar::obtenerPersona(std::size_t fila) const
+{
+    const ColumnasPoblacion c = obtenerColumnas();
+    return Persona::desdeCodigos(c.id[fila], c.edad[fila], c.sexo[fila], c.accesoInternet[fila] != 0,
+                                 c.distrito[fila], c.ingresos[fila], c.ubicacion[fila],
+                                 c.influenciabilidad[fila], c.gasto[fila]);
+}
+
+QVector<Persona> PoblacionColumnar::aPersonas() const
+{
+    QVector<Persona> personas;
+    personas.reserve(static_cast<int>(tamano()));
+    for (std::size_t i = 0; i < tamano(); ++i) {
+        personas.append(obtenerPersona(i));
+    }
+    return personas;
+}
+
+ColumnasPoblacion PoblacionColumnar::obtenerColumnas() const
+{
+    if (respaldo) {
+        return externas;
+    }
+    
+    ColumnasPoblacion columnas;
+    columnas.filas = tamano();
+    columnas.id = ids.data();
+    columnas.edad = edades.data();
+    columnas.sexo = sexos.data();
+    columnas.accesoInternet = accesosInternet.data();
+    columnas.distrito = distritos.data();
+    columnas.ubicacion = ubicaciones.data();
+    columnas.ingresos = ingresos.data();
+    columnas.influenciabilidad = influenciabilidades.data();
+    columnas.gasto = gastos.data();
+    return columnas;
+}
+
+ColumnasEscritura PoblacionColumnar::obtenerColumnasEscritura()
+{
+    materializar();
+    
+    ColumnasEscritura columnas;
+    columnas.filas = tamano();
+    columnas.id = ids.data();
+    columnas.edad = edades.data();
+    columnas.sexo = sexos.data();
+    columnas.accesoInternet = accesosInternet.data();
+    columnas.distrito = distritos.data();
+    columnas.ubicacion = ubicaciones.data();
+    columnas.ingresos = ingresos.data();
+    columnas.influenciabilidad = influenciabilidades.data();
+    columnas.gasto = gastos.data();
+    return columnas;
+}
+
+void PoblacionColumnar::adoptarColumnas(const ColumnasPoblacion& columnas, RespaldoColumnas nuevoRespaldo)
+{
+    // Liberar también la memoria de las columnas propias
+    *this = PoblacionColumnar();
+    externas = columnas;
+    respaldo = std::move(nuevoRespaldo);
+}
+
+void PoblacionColumnar::materializar()
+{
+    if (!respaldo) {
+        return;
+    }
+    
+    const ColumnasPoblacion c = externas;
+    const std::size_t n = c.filas;
+    ids.assign(c.id, c.id + n);
+    edades.assign(c.edad, c.edad + n);
+    sexos.assign(c.sexo, c.sexo + n);
+    accesosInternet.assign(c.accesoInternet, c.accesoInternet + n);
+    distritos.assign(c.distrito, c.distrito + n);
+    ubicaciones.assign(c.ubicacion, c.ubicacion + n);
+    ingresos.assign(c.ingresos, c.ingresos + n);
+    influenciabilidades.assign(c.influenciabilidad, c.influenciabilidad + n);
+    gastos.assign(c.gasto, c.gasto + n);
+    
+    respaldo.reset();
+    externas = ColumnasPoblacion();
+}
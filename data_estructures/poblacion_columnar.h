@@ -0,0 +1,140 @@
+#ifndef POBLACION_COLUMNAR_H
+#define POBLACION_COLUMNAR_H
+
+#include "persona.h"
+#include <QVector>
+#include <vector>
+#include <cstddef>
+#include <memory>
+
+// Vista de solo lectura sobre las columnas de una población.
+// Son punteros planos: el análisis y el modelo de uplift recorren
+// los datos sin depender del contenedor que los respalda.
+struct ColumnasPoblacion {
+    std::size_t filas = 0;
+    const qint32* id = nullptr;
+    const quint8* edad = nullptr;
+    const quint8* sexo = nullptr;                // CodigoSexo
+    const quint8* accesoInternet = nullptr;      // 0 o 1
+    const quint16* distrito = nullptr;           // Código en Catalogo::lugares
+    const quint16* ubicacion = nullptr;          // Código en Catalogo::lugares
+    const double* ingresos = nullptr;
+    const double* influenciabilidad = nullptr;
+    const double* gasto = nullptr;
+    
+    // Vista de las filas [inicio, inicio + cantidad)
+    ColumnasPoblacion subrango(std::size_t inicio, std::size_t cantidad) const
+    {
+        ColumnasPoblacion r;
+        r.filas = cantidad;
+        r.id = id + inicio;
+        r.edad = edad + inicio;
+        r.sexo = sexo + inicio;
+        r.accesoInternet = accesoInternet + inicio;
+        r.distrito = distrito + inicio;
+        r.ubicacion = ubicacion + inicio;
+        r.ingresos = ingresos + inicio;
+        r.influenciabilidad = influenciabilidad + inicio;
+        r.gasto = gasto + inicio;
+        return r;
+    }
+
+    // Mayor código de lugar en distrito y ubicación (0 si no hay filas)
+    quint16 maximoCodigoLugar() const
+    {
+        quint16 maximo = 0;
+        for (std::size_t i = 0; i < filas; ++i) {
+            maximo = distrito[i] > maximo ? distrito[i] : maximo;
+            maximo = ubicacion[i] > maximo ? ubicacion[i] : maximo;
+        }
+        return maximo;
+    }
+};
+
+// Vista de escritura sobre las columnas propias de una población, para
+// lectores que copian bloques enteros de cada columna
+struct ColumnasEscritura {
+    std::size_t filas = 0;
+    qint32* id = nullptr;
+    quint8* edad = nullptr;
+    quint8* sexo = nullptr;
+    quint8* accesoInternet = nullptr;
+    quint16* distrito = nullptr;
+    quint16* ubicacion = nullptr;
+    double* ingresos = nullptr;
+    double* influenciabilidad = nullptr;
+    double* gasto = nullptr;
+};
+
+// Población almacenada por columnas (structure-of-arrays).
+// Cada atributo vive en un arreglo contiguo, de modo que un filtro
+// por edad o acceso a internet solo trae a caché los bytes que usa.
+//
+// Las columnas pueden ser propias o externas (p. ej. un archivo mapeado).
+// Las externas se leen en el lugar; cualquier modificación las copia
+// antes a columnas propias.
+class PoblacionColumnar
+{
+public:
+    // Las edades se guardan en un byte; ninguna persona real supera este valor
+    static constexpr int EDAD_MAXIMA = 127;
+
+    // Mantiene vivas las columnas externas mientras la población las use
+    using RespaldoColumnas = std::shared_ptr<const void>;
+
+    PoblacionColumnar() = default;
+
+    // Capacidad y tamaño
+    std::size_t tamano() const { return respaldo ? externas.filas : ids.size(); }
+    bool estaVacia() const { return tamano() == 0; }
+    void reservar(std::size_t capacidad);
+    void limpiar();
+    void redimensionar(std::size_t filas);
+
+    // Conversión desde/hacia filas
+    void agregar(const Persona& persona);
+    Persona obtenerPersona(std::size_t fila) const;
+    QVector<Persona> aPersonas() const;
+    
+    // Escritura directa por posición, para cargadores que llenan filas en paralelo
+    // tras redimensionar(). La edad debe venir ya acotada a [0, EDAD_MAXIMA].
+    // Requieren columnas propias.
+    void establecerFila(std::size_t fila, qint32 id, quint8 edad, quint8 sexo, bool accesoInternet,
+                        quint16 distrito, quint16 ubicacion, double ingresos,
+                        double influenciabilidad, double gasto);
+    void establecerId(std::size_t fila, qint32 id) { ids[fila] = id; }
+    
+    // Copia filas [desde, desde + cantidad) a partir de hacia (hacia <= desde)
+    void moverFilas(std::size_t desde, std::size_t hacia, std::size_t cantidad);
+
+    // Reemplaza el contenido por las filas filas[0..cantidad) de origen, en
+    // ese orden y en columnas propias. origen no puede ser esta población.
+    void reunirFilas(const ColumnasPoblacion& origen, const quint32* filas, std::size_t cantidad);
+
+    // Acceso directo a las columnas para recorridos rápidos
+    ColumnasPoblacion obtenerColumnas() const;
+    ColumnasEscritura obtenerColumnasEscritura();
+
+    // Usa columnas externas sin copiarlas; respaldo las mantiene válidas
+    void adoptarColumnas(const ColumnasPoblacion& columnas, RespaldoColumnas respaldo);
+    bool tieneColumnasExternas() const { return respaldo != nullptr; }
+
+private:
+    // Copia las columnas externas a columnas propias
+    void materializar();
+
+    RespaldoColumnas respaldo;
+    ColumnasPoblacion externas;
+
+    std::vector<qint32> ids;
+    std::vector<quint8> edades;
+    std::vector<quint8> sexos;
+    std::vector<quint8> accesosInternet;
+    std::vector<quint16> distritos;
+    std::vector<quint16> ubicaciones;
+    std::vector<double> ingresos;
+    std::vector<double> influenciabilidades;
+    std::vector<double> gastos;
+};
+
+#endif // POBLACION_COLUMNAR_H
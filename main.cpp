@@ -1,5 +1,6 @@
 #include "ui/mainwindow.h"
 #include "system/uplifting_model.h"
+#include "cli/modo_lote.h"
 #include <QApplication>
 #include <QCommandLineParser>
 #include <QCommandLineOption>
@@ -7,6 +8,11 @@
 
 int main(int argc, char *argv[])
 {
+    // El modo por lotes no crea QApplication: arranca sin widgets ni pantalla
+    if (esModoLote(argc, argv)) {
+        return ejecutarModoLote(argc, argv);
+    }
+    
     QApplication a(argc, argv);
     
     // Configurar parser de línea de comandos
@@ -20,6 +26,10 @@ int main(int argc, char *argv[])
                                        "Ejecutar pruebas del modelo de uplift");
     parser.addOption(testUpliftOption);
     
+    // Solo para la ayuda: --lote se atiende antes de crear la aplicación
+    QCommandLineOption loteOption("lote", "Análisis por lotes sin interfaz gráfica (ver --lote --help)");
+    parser.addOption(loteOption);
+    
     // Procesar argumentos
     parser.process(a);
     
@@ -0,0 +1,267 @@
+#include <algorithm>
+#include <iostream>
+#include <iomanip>
+#include <functional>
+#include <string>
+#include <vector>
+#include <QElapsedTimer>
+#include <QDir>
+#include <QFile>
+#include "../data_estructures/gestor_datos.h"
+#include "../data_estructures/generador_poblacion.h"
+#include "../data_estructures/escritor_csv.h"
+#include "../system/analizador_trafico.h"
+#include "../system/uplifting_model.h"
+#include "../system/cubo_poblacion.h"
+#include "../system/grupo_hilos.h"
+
+// Mediciones del núcleo. Cada caso se repite y se informa la mejor vuelta,
+// para que los tiempos citados en la documentación puedan reproducirse:
+//
+//   benchmark_nucleo [personas] [hilos]
+//
+// personas: tamaño de la población generada (por defecto 1000000)
+// hilos: hilos del análisis, 0 = todos los disponibles (por defecto 0)
+
+namespace {
+
+const int REPETICIONES = 5;
+
+// Mejor tiempo de REPETICIONES vueltas, en milisegundos
+double medir(const std::string& nombre, const std::function<void()>& caso, std::size_t filas = 0)
+{
+    double mejor = -1.0;
+    for (int i = 0; i < REPETICIONES; ++i) {
+        QElapsedTimer reloj;
+        reloj.start();
+        caso();
+        const double ms = reloj.nsecsElapsed() / 1e6;
+        if (mejor < 0.0 || ms < mejor) {
+            mejor = ms;
+        }
+    }
+
+    std::cout << std::left << std::setw(48) << nombre << std::right << std::fixed
+              << std::setprecision(3) << std::setw(12) << mejor << " ms";
+    if (filas > 0) {
+        std::cout << std::setprecision(2) << std::setw(10) << mejor * 1e6 / filas << " ns/fila";
+    }
+    std::cout << std::endl;
+    return mejor;
+}
+
+void seccion(const std::string& titulo)
+{
+    std::cout << "\n--- " << titulo << " ---" << std::endl;
+}
+
+// Consulta de referencia: la más frecuente en la interfaz
+const ClienteIdeal CLIENTE(18, 65, "Cualquiera", true);
+const QString DISTRITO = "Miraflores";
+const QString PRODUCTO = "Ropa y Accesorios";
+const QString GEOGRAFICO = "Espacio Geográfico";
+
+volatile long long sumidero = 0;         // Evita que se descarten los resultados
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    const qint64 personas = argc > 1 ? std::stoll(argv[1]) : 1000000;
+    const int hilos = argc > 2 ? std::stoi(argv[2]) : 0;
+
+    std::cout << "=== MEDICIONES DEL NÚCLEO ===" << std::endl;
+    std::cout << "Personas: " << personas << ", hilos: " << (hilos > 0 ? std::to_string(hilos) : "todos")
+              << ", mejor de " << REPETICIONES << " vueltas" << std::endl;
+
+    GestorDatos gestor;
+    seccion("Población");
+    medir("Generar población", [&]() { gestor.generarPoblacion(personas); },
+          static_cast<std::size_t>(personas));
+    const PoblacionColumnar& poblacion = gestor.obtenerPoblacion();
+    const std::size_t filas = poblacion.tamano();
+
+    // Puntuación del árbol en un solo hilo: el costo por fila de cada evaluador
+    seccion("Puntuación de uplift (un hilo)");
+    {
+        UpliftModel::UpliftTreeModel modelo;
+        const UpliftModel::CompiledTree& arbol = modelo.compiledTree();
+        const ColumnasPoblacion columnas = poblacion.obtenerColumnas();
+        const std::vector<Persona> lista = [&]() {
+            const QVector<Persona> copia = poblacion.aPersonas();
+            return std::vector<Persona>(copia.begin(), copia.end());
+        }();
+        std::vector<double> puntuaciones(filas);
+
+        medir("Árbol enlazado (UpliftNode::evaluate)", [&]() {
+            for (std::size_t i = 0; i < filas; ++i) {
+                puntuaciones[i] = modelo.evaluateRecursive(lista[i]);
+            }
+        }, filas);
+        const UpliftModel::BatchBackend mejor = UpliftModel::CompiledTree::bestBatchBackend();
+        for (UpliftModel::BatchBackend backend : {UpliftModel::BatchBackend::Scalar,
+                                                  UpliftModel::BatchBackend::AVX2,
+                                                  UpliftModel::BatchBackend::AVX512}) {
+            if (static_cast<int>(backend) > static_cast<int>(mejor)) {
+                std::cout << "Árbol compilado, " << UpliftModel::CompiledTree::backendName(backend)
+                          << ": no disponible en este procesador" << std::endl;
+                continue;
+            }
+            medir(std::string("Árbol compilado, ") + UpliftModel::CompiledTree::backendName(backend), [&]() {
+                arbol.evaluateRange(columnas, 0, filas, puntuaciones.data(), backend);
+            }, filas);
+        }
+        sumidero += static_cast<long long>(puntuaciones[filas / 2] * 10);
+    }
+
+    AnalizadorTrafico analizador;
+    analizador.establecerNumeroHilos(hilos);
+    analizador.establecerSemilla(1);
+
+    seccion("Recorrido completo (distrito " + DISTRITO.toStdString() + ")");
+    medir("calcularTrafico", [&]() {
+        sumidero += analizador.calcularTrafico(poblacion, CLIENTE, DISTRITO, PRODUCTO, GEOGRAFICO);
+    }, filas);
+    medir("calcularTraficoConUplift", [&]() {
+        sumidero += analizador.calcularTraficoConUplift(poblacion, CLIENTE, DISTRITO, PRODUCTO, GEOGRAFICO);
+    }, filas);
+    medir("calcularTraficoEsperado", [&]() {
+        sumidero += static_cast<long long>(
+            analizador.calcularTraficoEsperado(poblacion, CLIENTE, DISTRITO, PRODUCTO, GEOGRAFICO).esperado);
+    }, filas);
+
+    // Índice de distritos: la consulta geográfica recorre solo su distrito
+    seccion("Índice de distritos");
+    {
+        // La población generada sale en el orden de los ids; una copia ordenada
+        // por distrito y edad mide el índice sin permutación
+        const ColumnasPoblacion c = poblacion.obtenerColumnas();
+        std::vector<quint32> porDistrito(filas);
+        for (std::size_t i = 0; i < filas; ++i) {
+            porDistrito[i] = static_cast<quint32>(i);
+        }
+        std::stable_sort(porDistrito.begin(), porDistrito.end(), [&](quint32 a, quint32 b) {
+            return c.distrito[a] != c.distrito[b] ? c.distrito[a] < c.distrito[b] : c.edad[a] < c.edad[b];
+        });
+        PoblacionColumnar ordenada;
+        ordenada.reunirFilas(c, porDistrito.data(), filas);
+        medir("IndiceDistritos::construir (con permutación)", [&]() {
+            IndiceDistritos indice;
+            indice.construir(poblacion);
+            sumidero += static_cast<long long>(indice.tamano());
+        }, filas);
+        medir("IndiceDistritos::construir (ya ordenada)", [&]() {
+            IndiceDistritos indice;
+            indice.construir(ordenada);
+            sumidero += static_cast<long long>(indice.tamano());
+        }, filas);
+        IndiceDistritos indiceDirecto;
+        indiceDirecto.construir(ordenada);
+        medir("calcularTrafico (índice directo, sin copia)", [&]() {
+            sumidero += analizador.calcularTrafico(indiceDirecto, CLIENTE, DISTRITO, PRODUCTO, GEOGRAFICO);
+        });
+    }
+    const IndiceDistritos& indice = gestor.obtenerIndiceDistritos();
+    medir("calcularTrafico (índice con permutación)", [&]() {
+        sumidero += analizador.calcularTrafico(indice, CLIENTE, DISTRITO, PRODUCTO, GEOGRAFICO);
+    });
+    medir("calcularTraficoEsperado (índice con permutación)", [&]() {
+        sumidero += static_cast<long long>(
+            analizador.calcularTraficoEsperado(indice, CLIENTE, DISTRITO, PRODUCTO, GEOGRAFICO).esperado);
+    });
+
+    // Mapas de bits: el tráfico sin uplift sale de AND/OR y conteo de bits
+    seccion("Índice de mapas de bits");
+    medir("IndiceBitmap::construir", [&]() {
+        IndiceBitmap bitmap;
+        bitmap.construir(poblacion);
+        sumidero += static_cast<long long>(bitmap.numPalabras());
+    }, filas);
+    const IndiceBitmap& bitmap = gestor.obtenerIndiceBitmap();
+    medir("calcularTrafico (mapas de bits)", [&]() {
+        sumidero += analizador.calcularTrafico(bitmap, CLIENTE, DISTRITO, PRODUCTO, GEOGRAFICO);
+    }, filas);
+
+    // Curva de alcance de diez umbrales: una pasada frente a dos por umbral
+    seccion("Curva de alcance (10 umbrales)");
+    const QVector<double> umbrales = {0.0, 0.1, 0.2, 0.3, 0.4, 0.5, 0.6, 0.7, 0.8, 0.9};
+    medir("calcularCurvaAlcance", [&]() {
+        sumidero += analizador.calcularCurvaAlcance(poblacion, CLIENTE, DISTRITO, PRODUCTO, GEOGRAFICO,
+                                                    umbrales)[0].traficoConUplift;
+    }, filas);
+    medir("ConUplift + Esperado por umbral", [&]() {
+        for (double umbral : umbrales) {
+            sumidero += analizador.calcularTraficoConUplift(poblacion, CLIENTE, DISTRITO, PRODUCTO, GEOGRAFICO,
+                                                            umbral);
+            sumidero += static_cast<long long>(analizador.calcularTraficoEsperado(
+                poblacion, CLIENTE, DISTRITO, PRODUCTO, GEOGRAFICO, umbral).esperado);
+        }
+    }, filas);
+    medir("calcularCurvaAlcance (índice)", [&]() {
+        sumidero += analizador.calcularCurvaAlcance(indice, CLIENTE, DISTRITO, PRODUCTO, GEOGRAFICO,
+                                                    umbrales)[0].traficoConUplift;
+    });
+
+    // Cubo: una pasada para agruparlo y luego cada consulta suma celdas
+    seccion("Cubo de la población");
+    CuboPoblacion cubo;
+    medir("construirCubo", [&]() { analizador.construirCubo(poblacion, cubo); }, filas);
+    std::cout << "Celdas: " << cubo.numCeldas() << std::endl;
+    medir("calcularTraficoEsperado (cubo)", [&]() {
+        sumidero += static_cast<long long>(
+            analizador.calcularTraficoEsperado(cubo, CLIENTE, DISTRITO, PRODUCTO, GEOGRAFICO).esperado);
+    });
+
+    // Cien escenarios: una pasada compartida frente a sumar celdas
+    QVector<EscenarioTrafico> escenarios;
+    const QVector<QString> distritos = gestor.obtenerDistritos();
+    for (int i = 0; i < 100; ++i) {
+        escenarios.append(EscenarioTrafico(ClienteIdeal(18 + i % 20, 40 + i % 30, "Cualquiera", i % 2 == 0),
+                                           distritos[i % distritos.size()], PRODUCTO, GEOGRAFICO,
+                                           0.1 * (i % 8)));
+    }
+    seccion("100 escenarios");
+    medir("calcularEscenarios (población)", [&]() {
+        QVector<ResultadoEscenario> resultados;
+        analizador.calcularEscenarios(poblacion, escenarios, resultados);
+        sumidero += resultados[0].trafico;
+    }, filas);
+    medir("calcularEscenarios (cubo ya construido)", [&]() {
+        sumidero += analizador.calcularEscenarios(cubo, escenarios)[0].trafico;
+    });
+
+    // Generación a CSV por lotes: el escritor formatea en el grupo global,
+    // donde espera a que se genere cada lote, o en un grupo propio que se
+    // solapa con la generación. Ocho lotes para que haya solapamiento
+    seccion("Generación a CSV por lotes (8 lotes)");
+    {
+        QVector<quint16> codigos;
+        for (const QString& distrito : distritos) {
+            codigos.append(Catalogo::lugares().internar(distrito));
+        }
+        const GeneradorPoblacion generador(1, codigos);
+        const std::size_t filasPorLote = static_cast<std::size_t>(std::max<qint64>(1, (personas + 7) / 8));
+        const QString ruta = QDir::tempPath() + "/benchmark_nucleo_lotes.csv";
+        GrupoHilos hilosEscritura(GrupoHilos::global().tamano());
+
+        medir("Solo generar", [&]() {
+            generador.generarEnLotes(personas, [](const PoblacionColumnar&) { return true; },
+                                     nullptr, filasPorLote);
+        }, static_cast<std::size_t>(personas));
+        for (GrupoHilos* grupo : {&GrupoHilos::global(), &hilosEscritura}) {
+            medir(grupo == &hilosEscritura ? "Generar y escribir, escritor con grupo propio"
+                                           : "Generar y escribir, escritor en el grupo global", [&]() {
+                EscritorCSV escritor(ruta, grupo);
+                if (escritor.abrir()) {
+                    generador.generarEnLotes(personas, [&](const PoblacionColumnar& lote) {
+                        return escritor.escribir(lote);
+                    }, nullptr, filasPorLote);
+                }
+                sumidero += escritor.cerrar().bytes;
+            }, static_cast<std::size_t>(personas));
+        }
+        QFile::remove(ruta);
+    }
+
+    return 0;
+}
@@ -10,10 +10,11 @@ cd "$(dirname "$0")/.."
 
 echo "Compilando pruebas independientes del modelo de uplift..."
 
-# Compilar el programa de pruebas independiente simplificado
-g++ -std=c++17 \
-    scripts/test_uplift_standalone_simple.cpp \
-    -o scripts/test_uplift_standalone
+# Las pruebas enlazan la biblioteca del núcleo: el mismo modelo que usa la
+# aplicación. Solo se necesita QtCore, no la interfaz gráfica.
+BUILD_DIR="build-pruebas-uplift"
+cmake -S . -B "$BUILD_DIR" -DPUBLICIDAD_INTERFAZ=OFF -DPUBLICIDAD_PRUEBAS=ON \
+    && cmake --build "$BUILD_DIR" --target prueba_uplift prueba_analizador -j"$(nproc)"
 
 if [ $? -ne 0 ]; then
     echo "Error: Falló la compilación de las pruebas independientes"
@@ -27,7 +28,7 @@ echo "Ejecutando pruebas independientes..."
 echo "====================================="
 
 # Ejecutar las pruebas
-./scripts/test_uplift_standalone
+ctest --test-dir "$BUILD_DIR" --output-on-failure
 
 if [ $? -eq 0 ]; then
     echo ""
@@ -39,7 +40,7 @@ else
 fi
 
 # Limpiar archivos temporales
-rm -f ./scripts/test_uplift_standalone
+rm -rf "./$BUILD_DIR"
 
 echo ""
 echo "=== PRUEBAS INDEPENDIENTES COMPLETADAS ==="
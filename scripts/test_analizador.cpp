@@ -0,0 +1,735 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <QDir>
+#include "../data_estructures/gestor_datos.h"
+#include "../data_estructures/poblacion_columnar.h"
+#include "../data_estructures/escritor_csv.h"
+#include "../data_estructures/instantanea_poblacion.h"
+#include "../data_estructures/fuente_poblacion.h"
+#include "../system/analizador_trafico.h"
+#include "../system/cubo_poblacion.h"
+#include "../system/grupo_hilos.h"
+
+// Pruebas de equivalencia del análisis: cada camino rápido debe dar el
+// mismo resultado que el recorrido completo de la población.
+
+namespace {
+
+int fallos = 0;
+
+void comprobar(bool correcto, const std::string& descripcion)
+{
+    std::cout << (correcto ? "✓ " : "✗ ") << descripcion << std::endl;
+    if (!correcto) {
+        ++fallos;
+    }
+}
+
+const qint64 TAMANO_POBLACION = 300000;
+const quint64 SEMILLA_ANALISIS = 12345;
+
+// Consultas representativas: geográficas y digitales, con y sin filtros
+struct Consulta {
+    ClienteIdeal cliente;
+    QString espacio;
+    QString producto;
+    QString tipoEspacio;
+};
+
+QVector<Consulta> consultasDePrueba()
+{
+    return {
+        {ClienteIdeal(18, 65, "Cualquiera", true), "Miraflores", "Ropa y Accesorios", "Espacio Geográfico"},
+        {ClienteIdeal(25, 40, "Femenino", false), "Surco", "Electrónicos y Tecnología", "Espacio Geográfico"},
+        {ClienteIdeal(15, 80, "Masculino", false), "Comas", "Automotriz", "Espacio Geográfico"},
+        {ClienteIdeal(18, 30, "Cualquiera", true), "Facebook", "Entretenimiento Digital", "Plataforma Digital"},
+        {ClienteIdeal(41, 59, "Femenino", true), "TikTok", "Salud y Belleza", "Digital"},
+    };
+}
+
+std::string describir(const Consulta& c)
+{
+    return c.espacio.toStdString() + " / " + c.producto.toStdString() + " / " +
+           std::to_string(c.cliente.edadMin) + "-" + std::to_string(c.cliente.edadMax);
+}
+
+// El recorrido columnar coincide con el recorrido por personas, y el
+// resultado no depende del número de hilos
+void probarRecorridoColumnar(const GestorDatos& gestor)
+{
+    std::cout << "\n=== RECORRIDO COLUMNAR ===" << std::endl;
+    const PoblacionColumnar& poblacion = gestor.obtenerPoblacion();
+    const QVector<Persona> personas = poblacion.aPersonas();
+
+    AnalizadorTrafico paralelo;
+    paralelo.establecerSemilla(SEMILLA_ANALISIS);
+    AnalizadorTrafico serial;
+    serial.establecerSemilla(SEMILLA_ANALISIS);
+    serial.establecerNumeroHilos(1);
+
+    for (const Consulta& c : consultasDePrueba()) {
+        const int porPersonas = paralelo.calcularTraficoConUplift(personas, c.cliente, c.espacio,
+                                                                  c.producto, c.tipoEspacio, 0.5);
+        const int columnar = paralelo.calcularTraficoConUplift(poblacion, c.cliente, c.espacio,
+                                                               c.producto, c.tipoEspacio, 0.5);
+        const int enSerie = serial.calcularTraficoConUplift(poblacion, c.cliente, c.espacio,
+                                                            c.producto, c.tipoEspacio, 0.5);
+        comprobar(porPersonas == columnar && columnar == enSerie,
+                  describir(c) + ": " + std::to_string(columnar) + " con uplift");
+
+        comprobar(paralelo.calcularTrafico(personas, c.cliente, c.espacio, c.producto, c.tipoEspacio) ==
+                  paralelo.calcularTrafico(poblacion, c.cliente, c.espacio, c.producto, c.tipoEspacio),
+                  describir(c) + ": tráfico por personas = columnar");
+
+        // La comprobación por persona, sin consulta resuelta, da el mismo conteo
+        int porCriterio = 0;
+        for (const Persona& persona : personas) {
+            if (paralelo.cumpleCriterioInclusion(persona, c.cliente, c.producto, c.espacio, c.tipoEspacio)) {
+                ++porCriterio;
+            }
+        }
+        comprobar(porCriterio == paralelo.calcularTrafico(poblacion, c.cliente, c.espacio,
+                                                          c.producto, c.tipoEspacio),
+                  describir(c) + ": criterio por persona = recorrido");
+    }
+}
+
+bool mismasColumnas(const ColumnasPoblacion& a, const ColumnasPoblacion& b)
+{
+    if (a.filas != b.filas) {
+        return false;
+    }
+    for (std::size_t i = 0; i < a.filas; ++i) {
+        if (a.id[i] != b.id[i] || a.edad[i] != b.edad[i] || a.sexo[i] != b.sexo[i] ||
+            a.accesoInternet[i] != b.accesoInternet[i] || a.distrito[i] != b.distrito[i] ||
+            a.ubicacion[i] != b.ubicacion[i] || a.ingresos[i] != b.ingresos[i] ||
+            a.influenciabilidad[i] != b.influenciabilidad[i] || a.gasto[i] != b.gasto[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// El tope de limitar() vale para todas las llamadas a ejecutar(), no solo
+// para las que pasan maxHilos (así --hilos limita también carga y generación)
+void probarLimiteHilos()
+{
+    std::cout << "\n=== LÍMITE DE HILOS ===" << std::endl;
+    GrupoHilos grupo(4);
+    grupo.limitar(2);
+    std::mutex mutex;
+    std::set<std::thread::id> usados;
+    grupo.ejecutar(256, [&](std::size_t) {
+        std::this_thread::sleep_for(std::chrono::microseconds(50));
+        std::lock_guard<std::mutex> bloqueo(mutex);
+        usados.insert(std::this_thread::get_id());
+    });
+    const std::size_t conTope = usados.size();
+    comprobar(grupo.tamano() == 2 && conTope <= 2,
+              "Con tope 2: " + std::to_string(conTope) + " hilos de 4 trabajaron");
+
+    grupo.limitar(0);
+    comprobar(grupo.tamano() == 4, "Sin tope: " + std::to_string(grupo.tamano()) + " hilos disponibles");
+}
+
+// La generación directa a archivo, leída de vuelta, es la misma población
+// que la generada en memoria con la misma semilla
+void probarGeneracionEnArchivo()
+{
+    std::cout << "\n=== GENERACIÓN EN ARCHIVO ===" << std::endl;
+    const qint64 tamano = 200000;
+    const quint64 semilla = 777;
+    GestorDatos enMemoria;
+    enMemoria.generarPoblacion(tamano, semilla);
+    const ColumnasPoblacion esperadas = enMemoria.obtenerPoblacion().obtenerColumnas();
+
+    const QString rutaCSV = QDir::tempPath() + "/prueba_analizador_generada.csv";
+    const QString rutaInstantanea = QDir::tempPath() + "/prueba_analizador_generada.pobl";
+
+    GestorDatos desdeCSV;
+    const bool csvGenerado = desdeCSV.generarPoblacionEnArchivo(rutaCSV, tamano, semilla, GestorDatos::FORMATO_CSV);
+    desdeCSV.cargarPoblacionDesdeCSV(rutaCSV);
+    comprobar(csvGenerado && mismasColumnas(esperadas, desdeCSV.obtenerPoblacion().obtenerColumnas()),
+              "CSV: " + std::to_string(desdeCSV.obtenerPoblacion().tamano()) + " filas iguales a las generadas");
+
+    GestorDatos desdeInstantanea;
+    const bool instantaneaGenerada = desdeInstantanea.generarPoblacionEnArchivo(
+        rutaInstantanea, tamano, semilla, GestorDatos::FORMATO_INSTANTANEA);
+    const bool instantaneaCargada = desdeInstantanea.cargarInstantanea(rutaInstantanea, true);
+    comprobar(instantaneaGenerada && instantaneaCargada &&
+                  mismasColumnas(esperadas, desdeInstantanea.obtenerPoblacion().obtenerColumnas()),
+              "Instantánea: " + std::to_string(desdeInstantanea.obtenerPoblacion().tamano()) +
+                  " filas iguales a las generadas");
+    comprobar(desdeInstantanea.obtenerPoblacion().tieneColumnasExternas(),
+              "Instantánea generada por lotes: el índice no copia las columnas mapeadas");
+
+    // El índice no cambia el orden de las filas: cargar y guardar un CSV lo reproduce
+    const QString rutaCopia = QDir::tempPath() + "/prueba_analizador_copia.csv";
+    desdeCSV.guardarPoblacionEnCSV(rutaCopia);
+    QFile original(rutaCSV);
+    QFile copia(rutaCopia);
+    const bool iguales = original.open(QIODevice::ReadOnly) && copia.open(QIODevice::ReadOnly) &&
+                         original.readAll() == copia.readAll();
+    comprobar(iguales, "CSV cargado y guardado: mismo archivo");
+
+    QFile::remove(rutaCSV);
+    QFile::remove(rutaCopia);
+    QFile::remove(rutaInstantanea);
+}
+
+// Una fuente por lotes da el mismo resultado que la población cargada entera,
+// también para un distrito que el catálogo aún no conoce al consultar
+void probarFuenteConDistritoNuevo()
+{
+    std::cout << "\n=== FUENTE CSV CON UN DISTRITO FUERA DEL CATÁLOGO ===" << std::endl;
+    const QString distrito = "Distrito solo en el archivo";
+    const QString ruta = QDir::tempPath() + "/prueba_analizador_fuente.csv";
+    {
+        std::ofstream csv(ruta.toStdString());
+        csv << "Id,Edad,Sexo,AccesoInternet,Distrito,Ingresos,Ubicacion,Influenciabilidad,Gasto\n";
+        for (int i = 1; i <= 20000; ++i) {
+            csv << i << ',' << (15 + i % 60) << ',' << (i % 2 ? "Femenino" : "Masculino") << ','
+                << (i % 5 ? 1 : 0) << ',' << (i % 3 ? distrito.toStdString() : "Miraflores") << ','
+                << (1000 + (i * 37) % 9000) << ",Miraflores," << (i % 100) / 100.0 << ','
+                << (i * 13) % 2000 << '\n';
+        }
+    }
+
+    // La fuente se recorre antes de cargar el archivo entero, que internaría el distrito
+    const ClienteIdeal cliente(18, 65, "Cualquiera", false);
+    AnalizadorTrafico analizador;
+    analizador.establecerSemilla(SEMILLA_ANALISIS);
+    FuenteCSV fuente(ruta, 1, 64 * 1024);
+    int porLotes = 0;
+    const bool leido = fuente.abrir() &&
+                       analizador.calcularTrafico(fuente, cliente, distrito, "Ropa y Accesorios",
+                                                  "Espacio Geográfico", porLotes);
+    FuenteCSV fuenteUplift(ruta, 1, 64 * 1024);
+    int porLotesUplift = 0;
+    const bool leidoUplift = fuenteUplift.abrir() &&
+                             analizador.calcularTraficoConUplift(fuenteUplift, cliente, distrito,
+                                                                 "Ropa y Accesorios", "Espacio Geográfico",
+                                                                 porLotesUplift, 0.3);
+
+    PoblacionColumnar completa;
+    LectorCSV::cargar(ruta, completa, 1);
+    const int entera = analizador.calcularTrafico(completa, cliente, distrito, "Ropa y Accesorios",
+                                                  "Espacio Geográfico");
+    const int enteraUplift = analizador.calcularTraficoConUplift(completa, cliente, distrito, "Ropa y Accesorios",
+                                                                 "Espacio Geográfico", 0.3);
+    comprobar(leido && entera > 0 && porLotes == entera,
+              "tráfico por lotes = cargado entero (" + std::to_string(porLotes) + ")");
+    comprobar(leidoUplift && enteraUplift > 0 && porLotesUplift == enteraUplift,
+              "con uplift por lotes = cargado entero (" + std::to_string(porLotesUplift) + ")");
+
+    // Un nombre que no está en el archivo no coincide con ninguna fila ni
+    // queda en el catálogo compartido
+    const int lugaresAntes = Catalogo::lugares().tamano();
+    FuenteCSV fuenteErrata(ruta, 1, 64 * 1024);
+    int conErrata = -1;
+    const bool leidoErrata = fuenteErrata.abrir() &&
+                             analizador.calcularTrafico(fuenteErrata, cliente, "Mirafloers", "Ropa y Accesorios",
+                                                        "Espacio Geográfico", conErrata);
+    comprobar(leidoErrata && conErrata == 0 && Catalogo::lugares().tamano() == lugaresAntes &&
+              Catalogo::lugares().buscar("Mirafloers") < 0,
+              "espacio desconocido: 0 filas y el catálogo no cambia");
+    QFile::remove(ruta);
+}
+
+// Una instantánea dañada hace fallar el recorrido por lotes en lugar de
+// terminar con un conteo parcial
+void probarFuenteDanada(const GestorDatos& gestor)
+{
+    std::cout << "\n=== FUENTE CON UNA INSTANTÁNEA DAÑADA ===" << std::endl;
+    const QString ruta = QDir::tempPath() + "/prueba_analizador_danada.pobl";
+    const Consulta c = consultasDePrueba()[0];
+    AnalizadorTrafico analizador;
+    const int esperado = analizador.calcularTrafico(gestor.obtenerPoblacion(), c.cliente, c.espacio,
+                                                    c.producto, c.tipoEspacio);
+
+    InstantaneaPoblacion::guardar(ruta, gestor.obtenerPoblacion());
+    FuenteInstantanea intacta(ruta, true, 65536);
+    int trafico = -1;
+    const bool leida = intacta.abrir() &&
+                       analizador.calcularTrafico(intacta, c.cliente, c.espacio, c.producto, c.tipoEspacio, trafico);
+    comprobar(leida && trafico == esperado, "instantánea intacta: " + std::to_string(trafico) + " = cargada entera");
+
+    // Un byte alterado a mitad del archivo cae dentro de una columna
+    {
+        std::fstream archivo(ruta.toStdString(), std::ios::in | std::ios::out | std::ios::binary);
+        archivo.seekg(0, std::ios::end);
+        const std::streamoff mitad = archivo.tellg() / 2;
+        archivo.seekg(mitad);
+        const char original = static_cast<char>(archivo.get());
+        archivo.seekp(mitad);
+        archivo.put(static_cast<char>(original ^ 0x5A));
+    }
+    FuenteInstantanea danada(ruta, true, 65536);
+    const bool abierta = danada.abrir();
+    const bool completo = abierta &&
+        analizador.calcularTrafico(danada, c.cliente, c.espacio, c.producto, c.tipoEspacio, trafico);
+    comprobar(abierta && !completo && !danada.error().isEmpty(),
+              "instantánea dañada: el recorrido falla (" + danada.error().toStdString() + ")");
+    QFile::remove(ruta);
+}
+
+// Los escritores fijan el diccionario de lugares al abrir: un lote con un
+// lugar internado después debe hacer fallar la escritura
+void probarEscritoresConLugarNuevo()
+{
+    std::cout << "\n=== ESCRITORES CON LUGARES POSTERIORES A LA APERTURA ===" << std::endl;
+    const QString rutaCSV = QDir::tempPath() + "/prueba_analizador_lugar.csv";
+    const QString rutaInstantanea = QDir::tempPath() + "/prueba_analizador_lugar.cpob";
+
+    EscritorCSV csv(rutaCSV);
+    EscritorInstantanea instantanea(rutaInstantanea, 1);
+    const bool abiertos = csv.abrir() && instantanea.abrir();
+
+    PoblacionColumnar lote;
+    lote.agregar(Persona(1, 30, "Femenino", true, "Lugar creado tras abrir", 2000.0));
+
+    comprobar(abiertos && !csv.escribir(lote), "CSV: el lote se rechaza");
+    const EstadisticasEscritura escrituraCSV = csv.cerrar();
+    comprobar(!escrituraCSV.exito && !escrituraCSV.error.isEmpty(),
+              "CSV: cerrar informa el fallo (" + escrituraCSV.error.toStdString() + ")");
+
+    comprobar(abiertos && !instantanea.escribir(lote), "Instantánea: el lote se rechaza");
+    const ResultadoInstantanea resultado = instantanea.cerrar();
+    comprobar(!resultado.exito && !resultado.error.isEmpty(),
+              "Instantánea: cerrar informa el fallo (" + resultado.error.toStdString() + ")");
+    comprobar(!QFile::exists(rutaInstantanea), "Instantánea: no se publica el archivo");
+
+    QFile::remove(rutaCSV);
+}
+
+// Escritores y fuentes con grupo propio no esperan al grupo global: así el
+// consumidor de generarEnLotes escribe mientras se genera el lote siguiente,
+// y recorrerFuente lee un lote mientras analiza el anterior. El grupo global
+// queda ocupado hasta que terminan
+void probarEntradaSalidaConGrupoPropio(const GestorDatos& gestor)
+{
+    std::cout << "\n=== ENTRADA Y SALIDA CON GRUPO PROPIO ===" << std::endl;
+    const QString rutaCSV = QDir::tempPath() + "/prueba_analizador_grupo.csv";
+    const QString rutaInstantanea = QDir::tempPath() + "/prueba_analizador_grupo.pobl";
+    const PoblacionColumnar& poblacion = gestor.obtenerPoblacion();
+
+    GrupoHilos hilosPropios(2);
+    std::mutex mutex;
+    std::condition_variable cambio;
+    bool globalOcupado = false;
+    bool escrito = false;
+    bool csvCorrecto = false;
+    bool instantaneaCorrecta = false;
+    std::size_t filasLeidas = 0;
+
+    std::thread entradaSalida([&]() {
+        {
+            std::unique_lock<std::mutex> bloqueo(mutex);
+            cambio.wait(bloqueo, [&]() { return globalOcupado; });
+        }
+        EscritorCSV csv(rutaCSV, &hilosPropios);
+        csvCorrecto = csv.abrir() && csv.escribir(poblacion);
+        csvCorrecto = csv.cerrar().exito && csvCorrecto;
+
+        EscritorInstantanea instantanea(rutaInstantanea, static_cast<qint64>(poblacion.tamano()), &hilosPropios);
+        instantaneaCorrecta = instantanea.abrir() && instantanea.escribir(poblacion);
+        instantaneaCorrecta = instantanea.cerrar().exito && instantaneaCorrecta;
+
+        FuenteCSV fuente(rutaCSV, 1);
+        fuente.establecerHilos(&hilosPropios);
+        PoblacionColumnar lote;
+        if (fuente.abrir()) {
+            while (fuente.leerLote(lote)) {
+                filasLeidas += lote.tamano();
+            }
+        }
+        {
+            std::lock_guard<std::mutex> bloqueo(mutex);
+            escrito = true;
+        }
+        cambio.notify_all();
+    });
+
+    // Si escritores o fuente usaran el grupo global, esperarían a esta
+    // llamada hasta que venza el plazo
+    bool aTiempo = false;
+    GrupoHilos& global = GrupoHilos::global();
+    global.ejecutar(static_cast<std::size_t>(global.tamano()), [&](std::size_t tarea) {
+        if (tarea != 0) {
+            return;
+        }
+        std::unique_lock<std::mutex> bloqueo(mutex);
+        globalOcupado = true;
+        cambio.notify_all();
+        aTiempo = cambio.wait_for(bloqueo, std::chrono::seconds(30), [&]() { return escrito; });
+    });
+    entradaSalida.join();
+
+    comprobar(aTiempo, "Escritores y fuente terminan con el grupo global ocupado (" +
+                           std::to_string(global.tamano()) + " hilos)");
+    comprobar(csvCorrecto && instantaneaCorrecta, "CSV e instantánea escritos con el grupo propio");
+    comprobar(filasLeidas == poblacion.tamano(),
+              "Fuente CSV con el grupo propio: " + std::to_string(filasLeidas) + " filas leídas");
+
+    GestorDatos desdeInstantanea;
+    comprobar(desdeInstantanea.cargarInstantanea(rutaInstantanea, true) &&
+                  mismasColumnas(poblacion.obtenerColumnas(), desdeInstantanea.obtenerPoblacion().obtenerColumnas()),
+              "Instantánea escrita con el grupo propio: sumas y filas correctas");
+
+    QFile::remove(rutaCSV);
+    QFile::remove(rutaInstantanea);
+}
+
+// Una carga cancelada (como al cerrar la ventana) deja la población vacía,
+// con índices coherentes, y no deja un CSV a medias
+void probarCargaCancelada()
+{
+    std::cout << "\n=== CARGA CANCELADA ===" << std::endl;
+    const QString ruta = QDir::tempPath() + "/prueba_analizador_cancelada.csv";
+    const QString rutaCancelada = QDir::tempPath() + "/prueba_analizador_cancelada_guardada.csv";
+    std::atomic<bool> cancelado{false};
+
+    GestorDatos gestor;
+    gestor.generarPoblacion(20000, 5, nullptr, &cancelado);
+    gestor.guardarPoblacionEnCSV(ruta, nullptr, &cancelado);
+    comprobar(gestor.obtenerPoblacion().tamano() == 20000 && QFile::exists(ruta),
+              "Sin cancelar: población generada y guardada");
+
+    cancelado.store(true);
+    gestor.guardarPoblacionEnCSV(rutaCancelada, nullptr, &cancelado);
+    comprobar(!QFile::exists(rutaCancelada), "Guardado cancelado: no queda el CSV incompleto");
+
+    GestorDatos cargado;
+    cargado.cargarPoblacionDesdeCSV(ruta, nullptr, &cancelado);
+    comprobar(cargado.obtenerPoblacion().estaVacia() && !cargado.obtenerUltimaLectura().exito &&
+                  cargado.obtenerIndiceBitmap().tamano() == 0,
+              "Carga cancelada: población vacía e índices vacíos");
+
+    gestor.generarPoblacion(20000, 5, nullptr, &cancelado);
+    comprobar(gestor.obtenerPoblacion().estaVacia() && gestor.obtenerIndiceDistritos().tamano() == 0,
+              "Generación cancelada: población vacía e índices vacíos");
+
+    QFile::remove(ruta);
+}
+
+// Las consultas sobre el índice de distritos dan lo mismo que recorrer la
+// población entera, con permutación o con la población ya ordenada, y el
+// índice no toca la población
+void probarIndiceDistritos(const GestorDatos& gestor)
+{
+    std::cout << "\n=== ÍNDICE DE DISTRITOS ===" << std::endl;
+    const PoblacionColumnar& poblacion = gestor.obtenerPoblacion();
+    const IndiceDistritos& indice = gestor.obtenerIndiceDistritos();
+    const ColumnasPoblacion c = poblacion.obtenerColumnas();
+
+    bool ordenGenerado = c.filas > 0;
+    for (std::size_t fila = 1; ordenGenerado && fila < c.filas; ++fila) {
+        ordenGenerado = c.id[fila - 1] < c.id[fila];
+    }
+    comprobar(ordenGenerado && !indice.esOrdenDirecto() && indice.tamano() == poblacion.tamano(),
+              "la población conserva el orden generado; el índice es una permutación");
+
+    // Copia ordenada por distrito y edad: el índice la usa sin permutación
+    std::vector<quint32> porDistrito(c.filas);
+    for (std::size_t fila = 0; fila < c.filas; ++fila) {
+        porDistrito[fila] = static_cast<quint32>(fila);
+    }
+    std::stable_sort(porDistrito.begin(), porDistrito.end(), [&](quint32 a, quint32 b) {
+        return c.distrito[a] != c.distrito[b] ? c.distrito[a] < c.distrito[b] : c.edad[a] < c.edad[b];
+    });
+    PoblacionColumnar ordenada;
+    ordenada.reunirFilas(c, porDistrito.data(), c.filas);
+    IndiceDistritos directo;
+    directo.construir(ordenada);
+    comprobar(directo.esOrdenDirecto(), "población ordenada: índice sin permutación");
+
+    AnalizadorTrafico analizador;
+    analizador.establecerSemilla(SEMILLA_ANALISIS);
+    const IndiceDistritos* indices[] = {&indice, &directo};
+    for (const IndiceDistritos* i : indices) {
+        const std::string tipo = i->esOrdenDirecto() ? "directo" : "con permutación";
+        for (const Consulta& con : consultasDePrueba()) {
+            const bool trafico =
+                analizador.calcularTrafico(*i, con.cliente, con.espacio, con.producto, con.tipoEspacio) ==
+                analizador.calcularTrafico(poblacion, con.cliente, con.espacio, con.producto, con.tipoEspacio);
+            const bool uplift =
+                analizador.calcularTraficoConUplift(*i, con.cliente, con.espacio, con.producto, con.tipoEspacio) ==
+                analizador.calcularTraficoConUplift(poblacion, con.cliente, con.espacio, con.producto,
+                                                    con.tipoEspacio);
+            const EstimacionTrafico porIndice =
+                analizador.calcularTraficoEsperado(*i, con.cliente, con.espacio, con.producto, con.tipoEspacio);
+            const EstimacionTrafico porRecorrido =
+                analizador.calcularTraficoEsperado(poblacion, con.cliente, con.espacio, con.producto,
+                                                   con.tipoEspacio);
+            comprobar(trafico && uplift && porIndice.personasElegibles == porRecorrido.personasElegibles &&
+                          std::abs(porIndice.esperado - porRecorrido.esperado) <=
+                              1e-9 * std::max(1.0, porRecorrido.esperado),
+                      describir(con) + ": índice " + tipo + " = recorrido completo");
+        }
+    }
+
+    const QString ruta = QDir::tempPath() + "/prueba_analizador_indice.pobl";
+    InstantaneaPoblacion::guardar(ruta, poblacion);
+    GestorDatos mapeado;
+    const bool abierta = mapeado.cargarInstantanea(ruta);
+    comprobar(abierta && mapeado.obtenerPoblacion().tieneColumnasExternas() &&
+                  mapeado.obtenerIndiceDistritos().tamano() == poblacion.tamano(),
+              "instantánea sin ordenar: el índice no copia las columnas mapeadas");
+    QFile::remove(ruta);
+}
+
+// El conteo por mapas de bits coincide con el recorrido, también con un
+// espacio que no existe y con edades fuera de la población
+void probarIndiceBitmap(const GestorDatos& gestor)
+{
+    std::cout << "\n=== ÍNDICE DE MAPAS DE BITS ===" << std::endl;
+    const PoblacionColumnar& poblacion = gestor.obtenerPoblacion();
+    const IndiceBitmap& indice = gestor.obtenerIndiceBitmap();
+    comprobar(indice.tamano() == poblacion.tamano(), "un bit por persona");
+
+    QVector<Consulta> consultas = consultasDePrueba();
+    consultas.append({ClienteIdeal(0, 200, "Cualquiera", false), "Miraflores", "Automotriz", "Espacio Geográfico"});
+    consultas.append({ClienteIdeal(30, 30, "Masculino", true), "Distrito inexistente", "Automotriz",
+                      "Espacio Geográfico"});
+    AnalizadorTrafico analizador;
+    for (const Consulta& c : consultas) {
+        const int porBits = analizador.calcularTrafico(indice, c.cliente, c.espacio, c.producto, c.tipoEspacio);
+        const int porRecorrido = analizador.calcularTrafico(poblacion, c.cliente, c.espacio, c.producto,
+                                                            c.tipoEspacio);
+        comprobar(porBits == porRecorrido,
+                  describir(c) + ": " + std::to_string(porBits) + " por bits = recorrido");
+    }
+}
+
+// Valores esperados sumados en otro orden: iguales salvo redondeo
+bool mismaEstimacion(const EstimacionTrafico& a, const EstimacionTrafico& b)
+{
+    return a.personasElegibles == b.personasElegibles &&
+           std::abs(a.esperado - b.esperado) <= 1e-9 * std::max(1.0, a.esperado) &&
+           std::abs(a.varianza - b.varianza) <= 1e-9 * std::max(1.0, a.varianza);
+}
+
+// Varios escenarios en una pasada dan lo mismo que cada escenario por
+// separado; cancelado, el cálculo no entrega resultados parciales
+void probarEscenarios(const GestorDatos& gestor)
+{
+    std::cout << "\n=== ESCENARIOS EN UNA PASADA ===" << std::endl;
+    const PoblacionColumnar& poblacion = gestor.obtenerPoblacion();
+    AnalizadorTrafico analizador;
+    analizador.establecerSemilla(SEMILLA_ANALISIS);
+
+    QVector<EscenarioTrafico> escenarios;
+    for (const Consulta& c : consultasDePrueba()) {
+        for (double umbral : {0.0, 0.3, 0.7}) {
+            escenarios.append(EscenarioTrafico(c.cliente, c.espacio, c.producto, c.tipoEspacio, umbral));
+        }
+    }
+    QVector<ResultadoEscenario> resultados;
+    const bool completo = analizador.calcularEscenarios(poblacion, escenarios, resultados, 0.9);
+    comprobar(completo && resultados.size() == escenarios.size(),
+              std::to_string(resultados.size()) + " resultados, uno por escenario");
+
+    for (int i = 0; completo && i < escenarios.size(); ++i) {
+        const EscenarioTrafico& e = escenarios[i];
+        const ResultadoEscenario& r = resultados[i];
+        const int trafico = analizador.calcularTrafico(poblacion, e.cliente, e.espacio, e.producto, e.tipoEspacio);
+        const int uplift = analizador.calcularTraficoConUplift(poblacion, e.cliente, e.espacio, e.producto,
+                                                               e.tipoEspacio, e.umbralInfluenciabilidad);
+        const EstimacionTrafico estimacion = analizador.calcularTraficoEsperado(
+            poblacion, e.cliente, e.espacio, e.producto, e.tipoEspacio, e.umbralInfluenciabilidad, 0.9);
+        comprobar(r.trafico == trafico && r.traficoConUplift == uplift &&
+                      mismaEstimacion(r.estimacion, estimacion) &&
+                      std::abs(r.estimacion.limiteSuperior - estimacion.limiteSuperior) <= 1e-6,
+                  e.espacio.toStdString() + " umbral " + QString::number(e.umbralInfluenciabilidad).toStdString() +
+                      ": igual a las llamadas por separado");
+    }
+
+    ControlAnalisis control;
+    control.cancelar();
+    QVector<ResultadoEscenario> cancelados;
+    comprobar(!analizador.calcularEscenarios(poblacion, escenarios, cancelados, 0.95, &control) &&
+                  cancelados.isEmpty(),
+              "cancelado: devuelve false y ningún resultado");
+}
+
+// Cada punto de la curva de alcance es el resultado de las llamadas por
+// separado con su umbral, sobre la población y sobre el índice de distritos
+void probarCurvaAlcance(const GestorDatos& gestor)
+{
+    std::cout << "\n=== CURVA DE ALCANCE ===" << std::endl;
+    const PoblacionColumnar& poblacion = gestor.obtenerPoblacion();
+    const IndiceDistritos& indice = gestor.obtenerIndiceDistritos();
+    AnalizadorTrafico analizador;
+    analizador.establecerSemilla(SEMILLA_ANALISIS);
+    const QVector<double> umbrales = {0.9, 0.0, 0.3, 0.45, 0.5, 0.55, 0.7, 1.0, -0.1};
+
+    for (const Consulta& c : consultasDePrueba()) {
+        const QVector<PuntoAlcance> curva = analizador.calcularCurvaAlcance(
+            poblacion, c.cliente, c.espacio, c.producto, c.tipoEspacio, umbrales, 0.9);
+        const QVector<PuntoAlcance> curvaIndice = analizador.calcularCurvaAlcance(
+            indice, c.cliente, c.espacio, c.producto, c.tipoEspacio, umbrales, 0.9);
+        bool iguales = curva.size() == umbrales.size() && curvaIndice.size() == umbrales.size();
+        for (int i = 0; iguales && i < umbrales.size(); ++i) {
+            const int uplift = analizador.calcularTraficoConUplift(poblacion, c.cliente, c.espacio, c.producto,
+                                                                   c.tipoEspacio, umbrales[i]);
+            const EstimacionTrafico estimacion = analizador.calcularTraficoEsperado(
+                poblacion, c.cliente, c.espacio, c.producto, c.tipoEspacio, umbrales[i], 0.9);
+            iguales = curva[i].umbral == umbrales[i] && curva[i].traficoConUplift == uplift &&
+                      curvaIndice[i].traficoConUplift == uplift &&
+                      mismaEstimacion(curva[i].estimacion, estimacion) &&
+                      mismaEstimacion(curvaIndice[i].estimacion, estimacion);
+        }
+        comprobar(iguales, describir(c) + ": " + std::to_string(umbrales.size()) +
+                               " puntos iguales a las llamadas por separado");
+    }
+
+    // Un análisis cancelado lo informa en lugar de devolver una curva o un
+    // tráfico parciales como si fueran completos
+    const Consulta c = consultasDePrueba()[0];
+    ControlAnalisis cancelado;
+    cancelado.cancelar();
+    QVector<PuntoAlcance> curva;
+    QVector<PuntoAlcance> curvaIndice;
+    int trafico = 0;
+    int uplift = 0;
+    EstimacionTrafico estimacion;
+    const bool algunoCompleto =
+        analizador.calcularCurvaAlcance(poblacion, c.cliente, c.espacio, c.producto, c.tipoEspacio, umbrales,
+                                        curva, 0.9, &cancelado) ||
+        analizador.calcularCurvaAlcance(indice, c.cliente, c.espacio, c.producto, c.tipoEspacio, umbrales,
+                                        curvaIndice, 0.9, &cancelado) ||
+        analizador.calcularTrafico(poblacion, c.cliente, c.espacio, c.producto, c.tipoEspacio, trafico,
+                                   &cancelado) ||
+        analizador.calcularTraficoConUplift(indice, c.cliente, c.espacio, c.producto, c.tipoEspacio, uplift,
+                                            0.5, &cancelado) ||
+        analizador.calcularTraficoEsperado(poblacion, c.cliente, c.espacio, c.producto, c.tipoEspacio,
+                                           estimacion, 0.5, 0.95, &cancelado);
+    comprobar(!algunoCompleto && curva.isEmpty() && curvaIndice.isEmpty(),
+              "cancelado: curva y tráfico devuelven false, la curva vacía");
+
+    ControlAnalisis activo;
+    const bool completa = analizador.calcularCurvaAlcance(poblacion, c.cliente, c.espacio, c.producto,
+                                                          c.tipoEspacio, umbrales, curva, 0.9, &activo);
+    comprobar(completa && curva.size() == umbrales.size(), "sin cancelar: curva completa");
+}
+
+// Los conteos por edad se calculan una vez por consulta; cada rango de edad
+// recortado de ellos es igual a un recorrido nuevo con ese rango
+void probarConteosPorEdad(const GestorDatos& gestor)
+{
+    std::cout << "\n=== CONTEOS POR EDAD ===" << std::endl;
+    const PoblacionColumnar& poblacion = gestor.obtenerPoblacion();
+    const IndiceDistritos& indice = gestor.obtenerIndiceDistritos();
+    AnalizadorTrafico analizador;
+    analizador.establecerSemilla(SEMILLA_ANALISIS);
+    const QVector<double> umbrales = {0.0, 0.5, 0.7};
+    const std::vector<std::pair<int, int>> rangos = {{0, 120}, {18, 65}, {25, 25}, {30, 44}, {60, 99}, {50, 40}};
+
+    for (const Consulta& c : consultasDePrueba()) {
+        ConteosPorEdad conteos;
+        ConteosPorEdad conteosIndice;
+        const bool calculados =
+            analizador.calcularConteosPorEdad(poblacion, c.cliente, c.espacio, c.producto, c.tipoEspacio,
+                                              conteos) &&
+            analizador.calcularConteosPorEdad(indice, c.cliente, c.espacio, c.producto, c.tipoEspacio,
+                                              conteosIndice);
+        bool iguales = calculados;
+        for (std::size_t r = 0; iguales && r < rangos.size(); ++r) {
+            ClienteIdeal cliente = c.cliente;
+            cliente.edadMin = rangos[r].first;
+            cliente.edadMax = rangos[r].second;
+            const QVector<PuntoAlcance> recortada = analizador.calcularCurvaAlcance(conteos, cliente, umbrales, 0.9);
+            const QVector<PuntoAlcance> recortadaIndice =
+                analizador.calcularCurvaAlcance(conteosIndice, cliente, umbrales, 0.9);
+            const QVector<PuntoAlcance> nueva = analizador.calcularCurvaAlcance(
+                poblacion, cliente, c.espacio, c.producto, c.tipoEspacio, umbrales, 0.9);
+            iguales = recortada.size() == nueva.size() && recortadaIndice.size() == nueva.size();
+            for (int i = 0; iguales && i < nueva.size(); ++i) {
+                iguales = recortada[i].traficoConUplift == nueva[i].traficoConUplift &&
+                          recortadaIndice[i].traficoConUplift == nueva[i].traficoConUplift &&
+                          mismaEstimacion(recortada[i].estimacion, nueva[i].estimacion) &&
+                          mismaEstimacion(recortadaIndice[i].estimacion, nueva[i].estimacion);
+            }
+        }
+        comprobar(iguales, describir(c) + ": " + std::to_string(rangos.size()) +
+                               " rangos de edad iguales a un recorrido nuevo");
+    }
+}
+
+// Sumar las celdas del cubo da lo mismo que recorrer la población
+void probarCubo(const GestorDatos& gestor)
+{
+    std::cout << "\n=== CUBO DE LA POBLACIÓN ===" << std::endl;
+    const PoblacionColumnar& poblacion = gestor.obtenerPoblacion();
+    AnalizadorTrafico analizador;
+    CuboPoblacion cubo;
+    const bool construido = analizador.construirCubo(poblacion, cubo);
+    comprobar(construido && cubo.totalPersonas() == static_cast<qint64>(poblacion.tamano()),
+              std::to_string(cubo.numCeldas()) + " celdas con toda la población");
+
+    QVector<EscenarioTrafico> escenarios;
+    for (const Consulta& c : consultasDePrueba()) {
+        comprobar(analizador.calcularTrafico(cubo, c.cliente, c.espacio, c.producto, c.tipoEspacio) ==
+                      analizador.calcularTrafico(poblacion, c.cliente, c.espacio, c.producto, c.tipoEspacio),
+                  describir(c) + ": tráfico del cubo = recorrido");
+        comprobar(mismaEstimacion(
+                      analizador.calcularTraficoEsperado(cubo, c.cliente, c.espacio, c.producto, c.tipoEspacio, 0.3),
+                      analizador.calcularTraficoEsperado(poblacion, c.cliente, c.espacio, c.producto,
+                                                         c.tipoEspacio, 0.3)),
+                  describir(c) + ": estimación del cubo = recorrido");
+        escenarios.append(EscenarioTrafico(c.cliente, c.espacio, c.producto, c.tipoEspacio, 0.3));
+    }
+
+    const QVector<ResultadoEscenario> porCeldas = analizador.calcularEscenarios(cubo, escenarios);
+    QVector<ResultadoEscenario> porPersonas;
+    analizador.calcularEscenarios(poblacion, escenarios, porPersonas);
+    bool iguales = porCeldas.size() == porPersonas.size();
+    for (int i = 0; iguales && i < porCeldas.size(); ++i) {
+        iguales = porCeldas[i].trafico == porPersonas[i].trafico &&
+                  porCeldas[i].traficoConUplift == ResultadoEscenario::SIN_MUESTREO &&
+                  mismaEstimacion(porCeldas[i].estimacion, porPersonas[i].estimacion);
+    }
+    comprobar(iguales, "escenarios desde el cubo = escenarios recorriendo la población");
+}
+
+} // namespace
+
+int main()
+{
+    std::cout << "=== PRUEBAS DEL ANALIZADOR DE TRÁFICO ===" << std::endl;
+
+    GestorDatos gestor;
+    gestor.generarPoblacion(TAMANO_POBLACION);
+    std::cout << "Población de prueba: " << gestor.obtenerPoblacion().tamano() << " personas" << std::endl;
+
+    probarRecorridoColumnar(gestor);
+    probarIndiceDistritos(gestor);
+    probarIndiceBitmap(gestor);
+    probarCubo(gestor);
+    probarEscenarios(gestor);
+    probarCurvaAlcance(gestor);
+    probarConteosPorEdad(gestor);
+    probarLimiteHilos();
+    probarGeneracionEnArchivo();
+    probarFuenteConDistritoNuevo();
+    probarFuenteDanada(gestor);
+    probarEscritoresConLugarNuevo();
+    probarEntradaSalidaConGrupoPropio(gestor);
+    probarCargaCancelada();
+
+    if (fallos > 0) {
+        std::cout << "\n✗ " << fallos << " COMPROBACIONES FALLARON" << std::endl;
+        return 1;
+    }
+    std::cout << "\n=== PRUEBAS COMPLETADAS EXITOSAMENTE ===" << std::endl;
+    return 0;
+}
@@ -20,9 +20,9 @@ int main() {
         Persona joven_influenciable;
         joven_influenciable.id = 1;
         joven_influenciable.edad = 22;
-        joven_influenciable.sexo = "Femenino";
+        joven_influenciable.sexo = SEXO_FEMENINO;
         joven_influenciable.ingresos = 25000;
-        joven_influenciable.ubicacion = "Madrid";
+        joven_influenciable.ubicacion = Catalogo::lugares().internar("Madrid");
         joven_influenciable.influenciabilidad_digital = 0.8;
         joven_influenciable.gasto_promedio = 300;
         test_cases.push_back(joven_influenciable);
@@ -31,9 +31,9 @@ int main() {
         Persona mujer_alto_poder;
         mujer_alto_poder.id = 2;
         mujer_alto_poder.edad = 35;
-        mujer_alto_poder.sexo = "Femenino";
+        mujer_alto_poder.sexo = SEXO_FEMENINO;
         mujer_alto_poder.ingresos = 60000;
-        mujer_alto_poder.ubicacion = "Barcelona";
+        mujer_alto_poder.ubicacion = Catalogo::lugares().internar("Barcelona");
         mujer_alto_poder.influenciabilidad_digital = 0.6;
         mujer_alto_poder.gasto_promedio = 800;
         test_cases.push_back(mujer_alto_poder);
@@ -42,9 +42,9 @@ int main() {
         Persona hombre_altos_ingresos;
         hombre_altos_ingresos.id = 3;
         hombre_altos_ingresos.edad = 40;
-        hombre_altos_ingresos.sexo = "Masculino";
+        hombre_altos_ingresos.sexo = SEXO_MASCULINO;
         hombre_altos_ingresos.ingresos = 75000;
-        hombre_altos_ingresos.ubicacion = "Valencia";
+        hombre_altos_ingresos.ubicacion = Catalogo::lugares().internar("Valencia");
         hombre_altos_ingresos.influenciabilidad_digital = 0.4;
         hombre_altos_ingresos.gasto_promedio = 600;
         test_cases.push_back(hombre_altos_ingresos);
@@ -53,9 +53,9 @@ int main() {
         Persona joven_sin_recursos;
         joven_sin_recursos.id = 4;
         joven_sin_recursos.edad = 20;
-        joven_sin_recursos.sexo = "Masculino";
+        joven_sin_recursos.sexo = SEXO_MASCULINO;
         joven_sin_recursos.ingresos = 18000;
-        joven_sin_recursos.ubicacion = "Sevilla";
+        joven_sin_recursos.ubicacion = Catalogo::lugares().internar("Sevilla");
         joven_sin_recursos.influenciabilidad_digital = 0.5;
         joven_sin_recursos.gasto_promedio = 150;
         test_cases.push_back(joven_sin_recursos);
@@ -64,9 +64,9 @@ int main() {
         Persona hombre_ingresos_moderados;
         hombre_ingresos_moderados.id = 5;
         hombre_ingresos_moderados.edad = 45;
-        hombre_ingresos_moderados.sexo = "Masculino";
+        hombre_ingresos_moderados.sexo = SEXO_MASCULINO;
         hombre_ingresos_moderados.ingresos = 40000;
-        hombre_ingresos_moderados.ubicacion = "Bilbao";
+        hombre_ingresos_moderados.ubicacion = Catalogo::lugares().internar("Bilbao");
         hombre_ingresos_moderados.influenciabilidad_digital = 0.3;
         hombre_ingresos_moderados.gasto_promedio = 400;
         test_cases.push_back(hombre_ingresos_moderados);
@@ -79,7 +79,7 @@ int main() {
             double score = model.evaluateInfluenciability(persona);
             
             std::cout << "Caso " << (i + 1) << ":" << std::endl;
-            std::cout << "  Edad: " << persona.edad << ", Sexo: " << persona.sexo << std::endl;
+            std::cout << "  Edad: " << persona.edad << ", Sexo: " << persona.nombreSexo() << std::endl;
             std::cout << "  Ingresos: " << persona.ingresos << ", Gasto: " << persona.gasto_promedio << std::endl;
             std::cout << "  Influenciabilidad digital: " << persona.influenciabilidad_digital << std::endl;
             std::cout << "  Puntuación de uplift: " << score << std::endl;
@@ -142,6 +142,7 @@ int main() {
             std::cout << "\n✓ TODAS LAS VALIDACIONES PASARON CORRECTAMENTE" << std::endl;
         } else {
             std::cout << "\n✗ ALGUNAS VALIDACIONES FALLARON" << std::endl;
+            return 1;
         }
         
     } catch (const std::exception& e) {
@@ -1,4 +1,12 @@
 #include "analizador_trafico.h"
+#include "grupo_hilos.h"
+#include <algorithm>
+#include <cmath>
+#include <condition_variable>
+#include <deque>
+#include <limits>
+#include <mutex>
+#include <thread>
 
 // Constantes demográficas
 const double AnalizadorTrafico::PROB_ACCESO_JOVENES = 0.81;
@@ -17,9 +25,15 @@ const double AnalizadorTrafico::CONV_MAYORES = 0.01;
 const double AnalizadorTrafico::UMBRAL_ACCESO_MINIMO = 0.30;
 const double AnalizadorTrafico::UMBRAL_CONVERSION_MINIMO = 0.05;
 
+const std::size_t AnalizadorTrafico::TAMANO_BLOQUE = 65536;
+const quint64 AnalizadorTrafico::SEMILLA_POR_DEFECTO = 20240601;
+
 AnalizadorTrafico::AnalizadorTrafico()
+    : numeroHilos(0)
+    , semilla(SEMILLA_POR_DEFECTO)
 {
     configurarProductos();
+    construirTablasEdad();
     // Inicializar el modelo de uplift
     modeloUplift = std::make_unique<UpliftModel::UpliftTreeModel>();
 }
@@ -45,16 +59,36 @@ void AnalizadorTrafico::configurarProductos()
     };
 }
 
+void AnalizadorTrafico::construirTablasEdad()
+{
+    for (int edad = 0; edad < TABLA_EDADES; ++edad) {
+        tablaAcceso[edad] = obtenerProbabilidadAccesoDigital(edad);
+        tablaConversion[0][edad] = obtenerProbabilidadConversion(edad, false);
+        tablaConversion[1][edad] = obtenerProbabilidadConversion(edad, true);
+    }
+}
+
+void AnalizadorTrafico::establecerNumeroHilos(int hilos)
+{
+    numeroHilos = std::max(0, hilos);
+}
+
+void AnalizadorTrafico::establecerSemilla(quint64 nuevaSemilla)
+{
+    semilla = nuevaSemilla;
+}
+
 int AnalizadorTrafico::calcularTrafico(const QVector<Persona>& poblacion,
                                       const ClienteIdeal& cliente,
                                       const QString& espacio,
                                       const QString& producto,
                                       const QString& tipoEspacio)
 {
+    const ConsultaResuelta consulta = resolverConsulta(cliente, espacio, producto, tipoEspacio);
     int contador = 0;
     
     for (const auto& persona : poblacion) {
-        if (cumpleCriterioInclusion(persona, cliente, producto, espacio, tipoEspacio)) {
+        if (cumpleCriterioInclusion(persona, consulta)) {
             contador++;
         }
     }
@@ -62,20 +96,123 @@ int AnalizadorTrafico::calcularTrafico(const QVector<Persona>& poblacion,
     return contador;
 }
 
+int AnalizadorTrafico::calcularTrafico(const PoblacionColumnar& poblacion,
+                                      const ClienteIdeal& cliente,
+                                      const QString& espacio,
+                                      const QString& producto,
+                                      const QString& tipoEspacio)
+{
+    int trafico = 0;
+    calcularTrafico(poblacion, cliente, espacio, producto, tipoEspacio, trafico);
+    return trafico;
+}
+
+bool AnalizadorTrafico::calcularTrafico(const PoblacionColumnar& poblacion,
+                                       const ClienteIdeal& cliente,
+                                       const QString& espacio,
+                                       const QString& producto,
+                                       const QString& tipoEspacio,
+                                       int& trafico,
+                                       ControlAnalisis* control)
+{
+    const ConsultaResuelta consulta = resolverConsulta(cliente, espacio, producto, tipoEspacio);
+    ConteoParcial total = recorrerPorBloques(poblacion.obtenerColumnas(), consulta,
+                                             SOLO_INCLUSION, 0.0, control);
+    trafico = static_cast<int>(total.incluidos);
+    return !(control && control->estaCancelado());
+}
+
 bool AnalizadorTrafico::cumpleCriterioInclusion(const Persona& persona,
                                                const ClienteIdeal& cliente,
                                                const QString& producto,
                                                const QString& espacio,
                                                const QString& tipoEspacio)
 {
-    // 1. Verificar si cumple el perfil del cliente ideal
-    if (!cliente.cumpleRequisitos(persona)) {
-        return false;
+    // Comprobación directa, sin resolver la consulta entera: los criterios
+    // baratos van primero y el catálogo solo se consulta al final
+    if (!cliente.cumpleRequisitos(persona)) return false;
+    
+    const int edad = persona.edad;
+    const bool esDigital = productosDigitales.contains(producto);
+    const bool dentroDeTabla = edad >= 0 && edad < TABLA_EDADES;
+    const double acceso = dentroDeTabla ? tablaAcceso[edad] : obtenerProbabilidadAccesoDigital(edad);
+    const double conversion = dentroDeTabla ? tablaConversion[esDigital ? 1 : 0][edad]
+                                            : obtenerProbabilidadConversion(edad, esDigital);
+    if (acceso < UMBRAL_ACCESO_MINIMO || conversion < UMBRAL_CONVERSION_MINIMO) return false;
+    
+    if (tipoEspacio != "Espacio Geográfico") {
+        return persona.accesoInternet;
+    }
+    return persona.distrito == Catalogo::lugares().buscar(espacio);
+}
+
+AnalizadorTrafico::ConsultaResuelta AnalizadorTrafico::resolverConsulta(const ClienteIdeal& cliente,
+                                                                       const QString& espacio,
+                                                                       const QString& producto,
+                                                                       const QString& tipoEspacio) const
+{
+    ConsultaResuelta consulta;
+    consulta.edadMin = cliente.edadMin;
+    consulta.edadMax = cliente.edadMax;
+    consulta.sexo = cliente.sexo;
+    consulta.requiereInternet = cliente.requiereInternet;
+    consulta.esGeografico = (tipoEspacio == "Espacio Geográfico");
+    consulta.espacio = consulta.esGeografico ? Catalogo::lugares().buscar(espacio)
+                                             : Catalogo::plataformas().buscar(espacio);
+    consulta.productoDigital = productosDigitales.contains(producto);
+    consulta.productoVisual = productosVisuales.contains(producto);
+    consulta.aplicaProbAcceso = (tipoEspacio == "Digital");
+    
+    // Los criterios que dependen solo de la edad se resuelven aquí una vez
+    const double* conversion = tablaConversion[consulta.productoDigital ? 1 : 0];
+    for (int edad = 0; edad < TABLA_EDADES; ++edad) {
+        const bool umbrales = tablaAcceso[edad] >= UMBRAL_ACCESO_MINIMO &&
+                              conversion[edad] >= UMBRAL_CONVERSION_MINIMO;
+        consulta.edadAdmitida[edad] = umbrales && edad >= consulta.edadMin && edad <= consulta.edadMax;
+        
+        const double acceso = consulta.aplicaProbAcceso ? tablaAcceso[edad] : 1.0;
+        consulta.probabilidadBase[edad] = (acceso >= UMBRAL_ACCESO_MINIMO && conversion[edad] >= UMBRAL_CONVERSION_MINIMO)
+                                          ? acceso * conversion[edad] : 0.0;
+    }
+    return consulta;
+}
+
+bool AnalizadorTrafico::admiteEdad(int edad, const ConsultaResuelta& consulta)
+{
+    if (edad >= 0 && edad < TABLA_EDADES) {
+        return consulta.edadAdmitida[edad];
     }
+    return edad >= consulta.edadMin && edad <= consulta.edadMax &&
+           obtenerProbabilidadAccesoDigital(edad) >= UMBRAL_ACCESO_MINIMO &&
+           obtenerProbabilidadConversion(edad, consulta.productoDigital) >= UMBRAL_CONVERSION_MINIMO;
+}
+
+double AnalizadorTrafico::obtenerProbabilidadBase(int edad, const ConsultaResuelta& consulta)
+{
+    if (edad >= 0 && edad < TABLA_EDADES) {
+        return consulta.probabilidadBase[edad];
+    }
+    double probAcceso = consulta.aplicaProbAcceso ? obtenerProbabilidadAccesoDigital(edad) : 1.0;
+    double probConversion = obtenerProbabilidadConversion(edad, consulta.productoDigital);
+    if (probAcceso < UMBRAL_ACCESO_MINIMO || probConversion < UMBRAL_CONVERSION_MINIMO) {
+        return 0.0;
+    }
+    return probAcceso * probConversion;
+}
+
+bool AnalizadorTrafico::cumpleCriterioInclusion(const Persona& persona,
+                                               const ConsultaResuelta& consulta)
+{
+    // 1. Rango de edad del cliente y criterios de acceso y conversión por edad
+    if (!admiteEdad(persona.edad, consulta)) return false;
     
-    // 2. Verificar ubicación/espacio
-    if (tipoEspacio == "Espacio Geográfico") {
-        if (persona.distrito != espacio) {
+    // 2. Resto del perfil del cliente ideal
+    if (consulta.sexo != SEXO_CUALQUIERA && persona.sexo != consulta.sexo) return false;
+    if (consulta.requiereInternet && !persona.accesoInternet) return false;
+    
+    // 3. Verificar ubicación/espacio
+    if (consulta.esGeografico) {
+        if (persona.distrito != consulta.espacio) {
             return false;
         }
     } else { // Plataforma Digital
@@ -84,21 +221,27 @@ bool AnalizadorTrafico::cumpleCriterioInclusion(const Persona& persona,
         }
     }
     
-    // 3. Aplicar criterios específicos por edad
-    double probAcceso = obtenerProbabilidadAccesoDigital(persona.edad);
-    if (probAcceso < UMBRAL_ACCESO_MINIMO) {
-        return false;
-    }
+    return true;
+}
+
+// Misma lógica que la versión por Persona, leyendo directamente las columnas
+bool AnalizadorTrafico::cumpleCriterioInclusion(const ColumnasPoblacion& columnas,
+                                               std::size_t fila,
+                                               const ConsultaResuelta& consulta)
+{
+    // La edad ocupa un byte: la tabla cubre todos sus valores
+    if (!consulta.edadAdmitida[columnas.edad[fila]]) return false;
     
-    // 4. Aplicar criterios de conversión
-    double probConversion = obtenerProbabilidadConversion(persona.edad, producto);
-    if (probConversion < UMBRAL_CONVERSION_MINIMO) {
-        return false;
-    }
+    const bool accesoInternet = columnas.accesoInternet[fila] != 0;
+    if (consulta.sexo != SEXO_CUALQUIERA && columnas.sexo[fila] != consulta.sexo) return false;
+    if (consulta.requiereInternet && !accesoInternet) return false;
     
-    // 5. Criterio especial para productos visuales y sexo femenino
-    if (productosVisuales.contains(producto) && persona.sexo == "Femenino") {
-        return true; // Prioridad para productos visuales y mujeres
+    if (consulta.esGeografico) {
+        if (columnas.distrito[fila] != consulta.espacio) {
+            return false;
+        }
+    } else if (!accesoInternet) {
+        return false;
     }
     
     return true;
@@ -123,9 +266,13 @@ double AnalizadorTrafico::obtenerProbabilidadAccesoDigital(int edad)
 }
 
 double AnalizadorTrafico::obtenerProbabilidadConversion(int edad, const QString& producto)
+{
+    return obtenerProbabilidadConversion(edad, productosDigitales.contains(producto));
+}
+
+double AnalizadorTrafico::obtenerProbabilidadConversion(int edad, bool esDigital)
 {
     GrupoEtario grupo = obtenerGrupoEtario(edad);
-    bool esDigital = productosDigitales.contains(producto);
     
     switch (grupo) {
         case JOVENES:
@@ -157,42 +304,982 @@ int AnalizadorTrafico::calcularTraficoConUplift(const QVector<Persona>& poblacio
                                                const QString& tipoEspacio,
                                                double umbralInfluenciabilidad)
 {
+    const ConsultaResuelta consulta = resolverConsulta(cliente, espacio, producto, tipoEspacio);
     int personasInfluenciables = 0;
     
     for (const Persona& persona : poblacion) {
         // Aplicar filtros demográficos tradicionales
-        if (!cumpleCriterioInclusion(persona, cliente, producto, espacio, tipoEspacio)) {
+        if (!cumpleCriterioInclusion(persona, consulta)) {
             continue;
         }
         
-        // Aplicar probabilidades demográficas
-        double probAcceso = (tipoEspacio == "Digital") ? 
-            obtenerProbabilidadAccesoDigital(persona.edad) : 1.0;
+        // NUEVO: Aplicar filtro de influenciabilidad usando el modelo de uplift
+        double scoreInfluenciabilidad = modeloUplift->evaluateInfluenciability(persona);
+        double probabilidadFinal = obtenerProbabilidadFinal(persona.edad, scoreInfluenciabilidad,
+                                                            consulta, umbralInfluenciabilidad);
         
-        double probConversion = obtenerProbabilidadConversion(persona.edad, producto);
+        // Simular el resultado con el sorteo propio de la persona
+        if (probabilidadFinal > 0.0 && sortearPersona(persona.id) < probabilidadFinal) {
+            personasInfluenciables++;
+        }
+    }
+    
+    return personasInfluenciables;
+}
+
+int AnalizadorTrafico::calcularTraficoConUplift(const PoblacionColumnar& poblacion,
+                                               const ClienteIdeal& cliente,
+                                               const QString& espacio,
+                                               const QString& producto,
+                                               const QString& tipoEspacio,
+                                               double umbralInfluenciabilidad)
+{
+    int trafico = 0;
+    calcularTraficoConUplift(poblacion, cliente, espacio, producto, tipoEspacio, trafico,
+                             umbralInfluenciabilidad);
+    return trafico;
+}
+
+bool AnalizadorTrafico::calcularTraficoConUplift(const PoblacionColumnar& poblacion,
+                                                const ClienteIdeal& cliente,
+                                                const QString& espacio,
+                                                const QString& producto,
+                                                const QString& tipoEspacio,
+                                                int& trafico,
+                                                double umbralInfluenciabilidad,
+                                                ControlAnalisis* control)
+{
+    const ConsultaResuelta consulta = resolverConsulta(cliente, espacio, producto, tipoEspacio);
+    ConteoParcial total = recorrerPorBloques(poblacion.obtenerColumnas(), consulta,
+                                             MUESTREO, umbralInfluenciabilidad, control);
+    trafico = static_cast<int>(total.influenciables);
+    return !(control && control->estaCancelado());
+}
+
+EstimacionTrafico AnalizadorTrafico::calcularTraficoEsperado(const PoblacionColumnar& poblacion,
+                                                            const ClienteIdeal& cliente,
+                                                            const QString& espacio,
+                                                            const QString& producto,
+                                                            const QString& tipoEspacio,
+                                                            double umbralInfluenciabilidad,
+                                                            double nivelConfianza)
+{
+    EstimacionTrafico estimacion;
+    calcularTraficoEsperado(poblacion, cliente, espacio, producto, tipoEspacio, estimacion,
+                            umbralInfluenciabilidad, nivelConfianza);
+    return estimacion;
+}
+
+bool AnalizadorTrafico::calcularTraficoEsperado(const PoblacionColumnar& poblacion,
+                                               const ClienteIdeal& cliente,
+                                               const QString& espacio,
+                                               const QString& producto,
+                                               const QString& tipoEspacio,
+                                               EstimacionTrafico& estimacion,
+                                               double umbralInfluenciabilidad,
+                                               double nivelConfianza,
+                                               ControlAnalisis* control)
+{
+    const ConsultaResuelta consulta = resolverConsulta(cliente, espacio, producto, tipoEspacio);
+    ConteoParcial total = recorrerPorBloques(poblacion.obtenerColumnas(), consulta,
+                                             ESPERADO, umbralInfluenciabilidad, control);
+    estimacion = construirEstimacion(total, nivelConfianza);
+    return !(control && control->estaCancelado());
+}
+
+int AnalizadorTrafico::calcularTrafico(const IndiceDistritos& indice,
+                                      const ClienteIdeal& cliente,
+                                      const QString& espacio,
+                                      const QString& producto,
+                                      const QString& tipoEspacio)
+{
+    int trafico = 0;
+    calcularTrafico(indice, cliente, espacio, producto, tipoEspacio, trafico);
+    return trafico;
+}
+
+bool AnalizadorTrafico::calcularTrafico(const IndiceDistritos& indice,
+                                       const ClienteIdeal& cliente,
+                                       const QString& espacio,
+                                       const QString& producto,
+                                       const QString& tipoEspacio,
+                                       int& trafico,
+                                       ControlAnalisis* control)
+{
+    const ConsultaResuelta consulta = resolverConsulta(cliente, espacio, producto, tipoEspacio);
+    PoblacionColumnar copia;
+    ConteoParcial total = recorrerPorBloques(seleccionarFilas(indice, consulta, copia), consulta,
+                                             SOLO_INCLUSION, 0.0, control);
+    trafico = static_cast<int>(total.incluidos);
+    return !(control && control->estaCancelado());
+}
+
+int AnalizadorTrafico::calcularTraficoConUplift(const IndiceDistritos& indice,
+                                               const ClienteIdeal& cliente,
+                                               const QString& espacio,
+                                               const QString& producto,
+                                               const QString& tipoEspacio,
+                                               double umbralInfluenciabilidad)
+{
+    int trafico = 0;
+    calcularTraficoConUplift(indice, cliente, espacio, producto, tipoEspacio, trafico,
+                             umbralInfluenciabilidad);
+    return trafico;
+}
+
+bool AnalizadorTrafico::calcularTraficoConUplift(const IndiceDistritos& indice,
+                                                const ClienteIdeal& cliente,
+                                                const QString& espacio,
+                                                const QString& producto,
+                                                const QString& tipoEspacio,
+                                                int& trafico,
+                                                double umbralInfluenciabilidad,
+                                                ControlAnalisis* control)
+{
+    const ConsultaResuelta consulta = resolverConsulta(cliente, espacio, producto, tipoEspacio);
+    PoblacionColumnar copia;
+    ConteoParcial total = recorrerPorBloques(seleccionarFilas(indice, consulta, copia), consulta,
+                                             MUESTREO, umbralInfluenciabilidad, control);
+    trafico = static_cast<int>(total.influenciables);
+    return !(control && control->estaCancelado());
+}
+
+EstimacionTrafico AnalizadorTrafico::calcularTraficoEsperado(const IndiceDistritos& indice,
+                                                            const ClienteIdeal& cliente,
+                                                            const QString& espacio,
+                                                            const QString& producto,
+                                                            const QString& tipoEspacio,
+                                                            double umbralInfluenciabilidad,
+                                                            double nivelConfianza)
+{
+    EstimacionTrafico estimacion;
+    calcularTraficoEsperado(indice, cliente, espacio, producto, tipoEspacio, estimacion,
+                            umbralInfluenciabilidad, nivelConfianza);
+    return estimacion;
+}
+
+bool AnalizadorTrafico::calcularTraficoEsperado(const IndiceDistritos& indice,
+                                               const ClienteIdeal& cliente,
+                                               const QString& espacio,
+                                               const QString& producto,
+                                               const QString& tipoEspacio,
+                                               EstimacionTrafico& estimacion,
+                                               double umbralInfluenciabilidad,
+                                               double nivelConfianza,
+                                               ControlAnalisis* control)
+{
+    const ConsultaResuelta consulta = resolverConsulta(cliente, espacio, producto, tipoEspacio);
+    PoblacionColumnar copia;
+    ConteoParcial total = recorrerPorBloques(seleccionarFilas(indice, consulta, copia), consulta,
+                                             ESPERADO, umbralInfluenciabilidad, control);
+    estimacion = construirEstimacion(total, nivelConfianza);
+    return !(control && control->estaCancelado());
+}
+
+int AnalizadorTrafico::calcularTrafico(const IndiceBitmap& indice,
+                                      const ClienteIdeal& cliente,
+                                      const QString& espacio,
+                                      const QString& producto,
+                                      const QString& tipoEspacio)
+{
+    const ConsultaResuelta consulta = resolverConsulta(cliente, espacio, producto, tipoEspacio);
+    return static_cast<int>(indice.contar(compilarConsulta(indice, consulta)));
+}
+
+// Traduce cumpleCriterioInclusion a mapas: cada tramo contiguo de edades
+// admitidas (rango del cliente y umbrales del producto) es un rango
+// (edad <= b) AND NOT (edad <= a - 1); el resto del perfil y el espacio son
+// mapas requeridos
+IndiceBitmap::ConsultaBits AnalizadorTrafico::compilarConsulta(const IndiceBitmap& indice,
+                                                               const ConsultaResuelta& consulta) const
+{
+    IndiceBitmap::ConsultaBits bits;
+    
+    for (int edad = 0; edad < TABLA_EDADES; ) {
+        if (!consulta.edadAdmitida[edad]) {
+            ++edad;
+            continue;
+        }
+        const int primera = edad;
+        while (edad < TABLA_EDADES && consulta.edadAdmitida[edad]) {
+            ++edad;
+        }
+        bits.rangos.push_back({indice.edadHasta(edad - 1), indice.edadHasta(primera - 1)});
+    }
+    
+    if (consulta.sexo != SEXO_CUALQUIERA) {
+        bits.requeridos.push_back(indice.sexo(consulta.sexo));
+    }
+    if (consulta.requiereInternet || !consulta.esGeografico) {
+        bits.requeridos.push_back(indice.accesoInternet());
+    }
+    if (consulta.esGeografico) {
+        bits.requeridos.push_back(indice.distrito(consulta.espacio));
+    }
+    
+    return bits;
+}
+
+ColumnasPoblacion AnalizadorTrafico::seleccionarFilas(const IndiceDistritos& indice,
+                                                      const ConsultaResuelta& consulta,
+                                                      PoblacionColumnar& copia) const
+{
+    if (!consulta.esGeografico) {
+        return indice.obtenerColumnas();
+    }
+    RangoFilas rango = indice.rango(consulta.espacio, consulta.edadMin, consulta.edadMax);
+    return indice.filas(rango, copia);
+}
+
+bool AnalizadorTrafico::calcularTrafico(FuentePoblacion& fuente,
+                                       const ClienteIdeal& cliente,
+                                       const QString& espacio,
+                                       const QString& producto,
+                                       const QString& tipoEspacio,
+                                       int& trafico,
+                                       ControlAnalisis* control)
+{
+    const ConsultaResuelta consulta = resolverConsulta(cliente, espacio, producto, tipoEspacio);
+    ConteoParcial total;
+    const bool completo = recorrerFuente(fuente, consulta, espacio, SOLO_INCLUSION, 0.0, total, control);
+    trafico = static_cast<int>(total.incluidos);
+    return completo;
+}
+
+bool AnalizadorTrafico::calcularTraficoConUplift(FuentePoblacion& fuente,
+                                                const ClienteIdeal& cliente,
+                                                const QString& espacio,
+                                                const QString& producto,
+                                                const QString& tipoEspacio,
+                                                int& trafico,
+                                                double umbralInfluenciabilidad,
+                                                ControlAnalisis* control)
+{
+    const ConsultaResuelta consulta = resolverConsulta(cliente, espacio, producto, tipoEspacio);
+    ConteoParcial total;
+    const bool completo = recorrerFuente(fuente, consulta, espacio, MUESTREO, umbralInfluenciabilidad, total, control);
+    trafico = static_cast<int>(total.influenciables);
+    return completo;
+}
+
+bool AnalizadorTrafico::calcularTraficoEsperado(FuentePoblacion& fuente,
+                                               const ClienteIdeal& cliente,
+                                               const QString& espacio,
+                                               const QString& producto,
+                                               const QString& tipoEspacio,
+                                               EstimacionTrafico& estimacion,
+                                               double umbralInfluenciabilidad,
+                                               double nivelConfianza,
+                                               ControlAnalisis* control)
+{
+    const ConsultaResuelta consulta = resolverConsulta(cliente, espacio, producto, tipoEspacio);
+    ConteoParcial total;
+    const bool completo = recorrerFuente(fuente, consulta, espacio, ESPERADO, umbralInfluenciabilidad, total, control);
+    estimacion = construirEstimacion(total, nivelConfianza);
+    return completo;
+}
+
+bool AnalizadorTrafico::construirCubo(const PoblacionColumnar& poblacion, CuboPoblacion& cubo) const
+{
+    return cubo.construir(poblacion, modeloUplift->compiledTree());
+}
+
+int AnalizadorTrafico::calcularTrafico(const CuboPoblacion& cubo,
+                                      const ClienteIdeal& cliente,
+                                      const QString& espacio,
+                                      const QString& producto,
+                                      const QString& tipoEspacio)
+{
+    const ConsultaResuelta consulta = resolverConsulta(cliente, espacio, producto, tipoEspacio);
+    ConteoParcial total = contarCeldas(cubo, consulta, SOLO_INCLUSION, 0.0);
+    return static_cast<int>(total.incluidos);
+}
+
+EstimacionTrafico AnalizadorTrafico::calcularTraficoEsperado(const CuboPoblacion& cubo,
+                                                            const ClienteIdeal& cliente,
+                                                            const QString& espacio,
+                                                            const QString& producto,
+                                                            const QString& tipoEspacio,
+                                                            double umbralInfluenciabilidad,
+                                                            double nivelConfianza)
+{
+    const ConsultaResuelta consulta = resolverConsulta(cliente, espacio, producto, tipoEspacio);
+    ConteoParcial total = contarCeldas(cubo, consulta, ESPERADO, umbralInfluenciabilidad);
+    return construirEstimacion(total, nivelConfianza);
+}
+
+QVector<ResultadoEscenario> AnalizadorTrafico::calcularEscenarios(const CuboPoblacion& cubo,
+                                                                  const QVector<EscenarioTrafico>& escenarios,
+                                                                  double nivelConfianza)
+{
+    QVector<ResultadoEscenario> resultados(escenarios.size());
+    for (int i = 0; i < escenarios.size(); ++i) {
+        const EscenarioTrafico& e = escenarios[i];
+        const ConsultaResuelta consulta = resolverConsulta(e.cliente, e.espacio, e.producto, e.tipoEspacio);
+        const ConteoParcial total = contarCeldas(cubo, consulta, ESPERADO, e.umbralInfluenciabilidad);
+        resultados[i].trafico = static_cast<int>(total.incluidos);
+        resultados[i].traficoConUplift = ResultadoEscenario::SIN_MUESTREO;
+        resultados[i].estimacion = construirEstimacion(total, nivelConfianza);
+    }
+    return resultados;
+}
+
+bool AnalizadorTrafico::calcularEscenarios(const PoblacionColumnar& poblacion,
+                                           const QVector<EscenarioTrafico>& escenarios,
+                                           QVector<ResultadoEscenario>& resultados,
+                                           double nivelConfianza,
+                                           ControlAnalisis* control)
+{
+    resultados.clear();
+    const std::size_t numEscenarios = static_cast<std::size_t>(escenarios.size());
+    std::vector<ConsultaResuelta> consultas;
+    consultas.reserve(numEscenarios);
+    for (const EscenarioTrafico& e : escenarios) {
+        consultas.push_back(resolverConsulta(e.cliente, e.espacio, e.producto, e.tipoEspacio));
+    }
+    
+    const ColumnasPoblacion columnas = poblacion.obtenerColumnas();
+    const std::size_t numBloques = (columnas.filas + TAMANO_BLOQUE - 1) / TAMANO_BLOQUE;
+    std::vector<ConteoParcial> parciales(numBloques * numEscenarios);
+    std::atomic<std::size_t> bloquesHechos{0};
+    
+    if (numEscenarios > 0) {
+        GrupoHilos::global().ejecutar(numBloques, [&](std::size_t bloque) {
+            if (control && control->estaCancelado()) {
+                return;
+            }
+            contarBloqueEscenarios(columnas, consultas, escenarios, bloque,
+                                   &parciales[bloque * numEscenarios]);
+            
+            std::size_t hechos = bloquesHechos.fetch_add(1) + 1;
+            if (control && control->progreso) {
+                control->progreso(hechos, numBloques);
+            }
+        }, numeroHilos);
+    }
+    
+    if (control && control->estaCancelado()) {
+        return false;
+    }
+    
+    // Combinar en orden de bloque, escenario por escenario
+    resultados.resize(escenarios.size());
+    for (std::size_t k = 0; k < numEscenarios; ++k) {
+        ConteoParcial total;
+        for (std::size_t bloque = 0; bloque < numBloques; ++bloque) {
+            total.acumular(parciales[bloque * numEscenarios + k]);
+        }
+        ResultadoEscenario& r = resultados[static_cast<int>(k)];
+        r.trafico = static_cast<int>(total.incluidos);
+        r.traficoConUplift = static_cast<int>(total.influenciables);
+        r.estimacion = construirEstimacion(total, nivelConfianza);
+    }
+    return true;
+}
+
+QVector<PuntoAlcance> AnalizadorTrafico::calcularCurvaAlcance(const PoblacionColumnar& poblacion,
+                                                             const ClienteIdeal& cliente,
+                                                             const QString& espacio,
+                                                             const QString& producto,
+                                                             const QString& tipoEspacio,
+                                                             const QVector<double>& umbrales,
+                                                             double nivelConfianza)
+{
+    QVector<PuntoAlcance> curva;
+    calcularCurvaAlcance(poblacion, cliente, espacio, producto, tipoEspacio, umbrales,
+                         curva, nivelConfianza);
+    return curva;
+}
+
+bool AnalizadorTrafico::calcularCurvaAlcance(const PoblacionColumnar& poblacion,
+                                            const ClienteIdeal& cliente,
+                                            const QString& espacio,
+                                            const QString& producto,
+                                            const QString& tipoEspacio,
+                                            const QVector<double>& umbrales,
+                                            QVector<PuntoAlcance>& curva,
+                                            double nivelConfianza,
+                                            ControlAnalisis* control)
+{
+    const ConsultaResuelta consulta = resolverConsulta(cliente, espacio, producto, tipoEspacio);
+    return recorrerCurva(poblacion.obtenerColumnas(), consulta, umbrales, nivelConfianza, curva, control);
+}
+
+QVector<PuntoAlcance> AnalizadorTrafico::calcularCurvaAlcance(const IndiceDistritos& indice,
+                                                             const ClienteIdeal& cliente,
+                                                             const QString& espacio,
+                                                             const QString& producto,
+                                                             const QString& tipoEspacio,
+                                                             const QVector<double>& umbrales,
+                                                             double nivelConfianza)
+{
+    QVector<PuntoAlcance> curva;
+    calcularCurvaAlcance(indice, cliente, espacio, producto, tipoEspacio, umbrales, curva, nivelConfianza);
+    return curva;
+}
+
+bool AnalizadorTrafico::calcularCurvaAlcance(const IndiceDistritos& indice,
+                                            const ClienteIdeal& cliente,
+                                            const QString& espacio,
+                                            const QString& producto,
+                                            const QString& tipoEspacio,
+                                            const QVector<double>& umbrales,
+                                            QVector<PuntoAlcance>& curva,
+                                            double nivelConfianza,
+                                            ControlAnalisis* control)
+{
+    const ConsultaResuelta consulta = resolverConsulta(cliente, espacio, producto, tipoEspacio);
+    PoblacionColumnar copia;
+    return recorrerCurva(seleccionarFilas(indice, consulta, copia), consulta, umbrales, nivelConfianza,
+                         curva, control);
+}
+
+// El rango de edad del cliente no entra en los conteos: se admite toda edad
+bool AnalizadorTrafico::calcularConteosPorEdad(const PoblacionColumnar& poblacion,
+                                               const ClienteIdeal& cliente,
+                                               const QString& espacio,
+                                               const QString& producto,
+                                               const QString& tipoEspacio,
+                                               ConteosPorEdad& conteos,
+                                               ControlAnalisis* control)
+{
+    ClienteIdeal todasLasEdades = cliente;
+    todasLasEdades.edadMin = 0;
+    todasLasEdades.edadMax = ConteosPorEdad::EDADES - 1;
+    const ConsultaResuelta consulta = resolverConsulta(todasLasEdades, espacio, producto, tipoEspacio);
+    return recorrerPorEdad(poblacion.obtenerColumnas(), consulta, conteos, control);
+}
+
+bool AnalizadorTrafico::calcularConteosPorEdad(const IndiceDistritos& indice,
+                                               const ClienteIdeal& cliente,
+                                               const QString& espacio,
+                                               const QString& producto,
+                                               const QString& tipoEspacio,
+                                               ConteosPorEdad& conteos,
+                                               ControlAnalisis* control)
+{
+    ClienteIdeal todasLasEdades = cliente;
+    todasLasEdades.edadMin = 0;
+    todasLasEdades.edadMax = ConteosPorEdad::EDADES - 1;
+    const ConsultaResuelta consulta = resolverConsulta(todasLasEdades, espacio, producto, tipoEspacio);
+    PoblacionColumnar copia;
+    return recorrerPorEdad(seleccionarFilas(indice, consulta, copia), consulta, conteos, control);
+}
+
+QVector<PuntoAlcance> AnalizadorTrafico::calcularCurvaAlcance(const ConteosPorEdad& conteos,
+                                                             const ClienteIdeal& cliente,
+                                                             const QVector<double>& umbrales,
+                                                             double nivelConfianza) const
+{
+    const int edadMin = std::max(cliente.edadMin, 0);
+    const int edadMax = std::min(cliente.edadMax, ConteosPorEdad::EDADES - 1);
+    
+    std::vector<ConteoParcial> porHoja(conteos.numHojas());
+    for (std::size_t hoja = 0; hoja < conteos.numHojas(); ++hoja) {
+        for (int edad = edadMin; edad <= edadMax; ++edad) {
+            const ConteosPorEdad::Celda& celda = conteos.celda(edad, hoja);
+            ConteoParcial& total = porHoja[hoja];
+            total.incluidos += celda.incluidos;
+            total.influenciables += celda.influenciables;
+            total.elegibles += celda.elegibles;
+            total.esperado += celda.esperado;
+            total.varianza += celda.varianza;
+        }
+    }
+    return construirCurva(porHoja, conteos.puntuaciones(), umbrales, nivelConfianza);
+}
+
+EstimacionTrafico AnalizadorTrafico::construirEstimacion(const ConteoParcial& total, double nivelConfianza) const
+{
+    // Suma de Bernoulli independientes: aproximación normal del intervalo
+    double z = cuantilNormal(0.5 + nivelConfianza / 2.0);
+    double margen = z * std::sqrt(total.varianza);
+    double inferior = std::max(0.0, total.esperado - margen);
+    double superior = std::min(static_cast<double>(total.elegibles), total.esperado + margen);
+    
+    return EstimacionTrafico(total.esperado, total.varianza, inferior, superior,
+                             nivelConfianza, total.elegibles);
+}
+
+double AnalizadorTrafico::obtenerProbabilidadFinal(int edad, double scoreInfluenciabilidad,
+                                                  const ConsultaResuelta& consulta,
+                                                  double umbralInfluenciabilidad)
+{
+    if (scoreInfluenciabilidad < umbralInfluenciabilidad) {
+        return 0.0;
+    }
+    
+    // Probabilidad final con factores combinados
+    return obtenerProbabilidadBase(edad, consulta) * scoreInfluenciabilidad;
+}
+
+double AnalizadorTrafico::sortearPersona(int idPersona) const
+{
+    return GeneradorContador::uniforme(semilla, static_cast<quint32>(idPersona),
+                                       GeneradorContador::FLUJO_CONVERSION);
+}
+
+AnalizadorTrafico::ConteoParcial AnalizadorTrafico::contarBloque(const ColumnasPoblacion& columnas,
+                                                                const ConsultaResuelta& consulta,
+                                                                std::size_t bloque,
+                                                                ModoConteo modo,
+                                                                double umbralInfluenciabilidad)
+{
+    const std::size_t inicio = bloque * TAMANO_BLOQUE;
+    const std::size_t fin = std::min(inicio + TAMANO_BLOQUE, columnas.filas);
+    ConteoParcial parcial;
+    
+    for (std::size_t fila = inicio; fila < fin; ++fila) {
+        if (!cumpleCriterioInclusion(columnas, fila, consulta)) {
+            continue;
+        }
+        parcial.incluidos++;
         
-        if (probAcceso < UMBRAL_ACCESO_MINIMO || probConversion < UMBRAL_CONVERSION_MINIMO) {
+        if (modo == SOLO_INCLUSION) {
             continue;
         }
         
-        // NUEVO: Aplicar filtro de influenciabilidad usando el modelo de uplift
-        double scoreInfluenciabilidad = modeloUplift->evaluateInfluenciability(persona);
+        double scoreInfluenciabilidad = modeloUplift->evaluateInfluenciability(columnas, fila);
+        double probabilidadFinal = obtenerProbabilidadFinal(columnas.edad[fila], scoreInfluenciabilidad,
+                                                            consulta, umbralInfluenciabilidad);
+        if (probabilidadFinal <= 0.0) {
+            continue;
+        }
+        parcial.elegibles++;
+        
+        if (modo == ESPERADO) {
+            parcial.esperado += probabilidadFinal;
+            parcial.varianza += probabilidadFinal * (1.0 - probabilidadFinal);
+        } else if (sortearPersona(columnas.id[fila]) < probabilidadFinal) {
+            parcial.influenciables++;
+        }
+    }
+    
+    return parcial;
+}
+
+// contarBloque para varios escenarios a la vez. La puntuación de uplift del
+// bloque se evalúa en lote una sola vez y el sorteo de cada persona se hace
+// a lo sumo una vez, la primera que algún escenario lo necesita.
+void AnalizadorTrafico::contarBloqueEscenarios(const ColumnasPoblacion& columnas,
+                                               const std::vector<ConsultaResuelta>& consultas,
+                                               const QVector<EscenarioTrafico>& escenarios,
+                                               std::size_t bloque,
+                                               ConteoParcial* parciales)
+{
+    const std::size_t inicio = bloque * TAMANO_BLOQUE;
+    const std::size_t fin = std::min(inicio + TAMANO_BLOQUE, columnas.filas);
+    std::vector<double> puntuaciones(fin - inicio);
+    modeloUplift->compiledTree().evaluateRange(columnas, inicio, fin - inicio, puntuaciones.data());
+    
+    for (std::size_t fila = inicio; fila < fin; ++fila) {
+        const double scoreInfluenciabilidad = puntuaciones[fila - inicio];
+        double sorteo = -1.0;
         
-        if (scoreInfluenciabilidad >= umbralInfluenciabilidad) {
-            // Simular probabilidad final con factores combinados
-            double probabilidadFinal = probAcceso * probConversion * scoreInfluenciabilidad;
+        for (std::size_t k = 0; k < consultas.size(); ++k) {
+            const ConsultaResuelta& consulta = consultas[k];
+            if (!cumpleCriterioInclusion(columnas, fila, consulta)) {
+                continue;
+            }
+            ConteoParcial& parcial = parciales[k];
+            parcial.incluidos++;
             
-            // Usar un generador de números aleatorios para simular el resultado
-            QRandomGenerator* generator = QRandomGenerator::global();
-            double random = generator->generateDouble();
+            double probabilidadFinal = obtenerProbabilidadFinal(columnas.edad[fila], scoreInfluenciabilidad, consulta,
+                                                                escenarios[static_cast<int>(k)].umbralInfluenciabilidad);
+            if (probabilidadFinal <= 0.0) {
+                continue;
+            }
+            parcial.elegibles++;
+            parcial.esperado += probabilidadFinal;
+            parcial.varianza += probabilidadFinal * (1.0 - probabilidadFinal);
             
-            if (random < probabilidadFinal) {
-                personasInfluenciables++;
+            if (sorteo < 0.0) {
+                sorteo = sortearPersona(columnas.id[fila]);
+            }
+            if (sorteo < probabilidadFinal) {
+                parcial.influenciables++;
             }
         }
     }
+}
+
+// Como contarBloque, pero cada celda pesa por la cantidad de personas que agrupa
+AnalizadorTrafico::ConteoParcial AnalizadorTrafico::contarCeldas(const CuboPoblacion& cubo,
+                                                                const ConsultaResuelta& consulta,
+                                                                ModoConteo modo,
+                                                                double umbralInfluenciabilidad)
+{
+    const ColumnasPoblacion celdas = cubo.obtenerRepresentantes();
+    ConteoParcial parcial;
     
-    return personasInfluenciables;
+    for (std::size_t celda = 0; celda < celdas.filas; ++celda) {
+        if (!cumpleCriterioInclusion(celdas, celda, consulta)) {
+            continue;
+        }
+        const qint64 cantidad = cubo.cantidad(celda);
+        parcial.incluidos += cantidad;
+        
+        if (modo == SOLO_INCLUSION) {
+            continue;
+        }
+        
+        double probabilidadFinal = obtenerProbabilidadFinal(celdas.edad[celda], cubo.puntuacion(celda),
+                                                            consulta, umbralInfluenciabilidad);
+        if (probabilidadFinal <= 0.0) {
+            continue;
+        }
+        parcial.elegibles += cantidad;
+        parcial.esperado += cantidad * probabilidadFinal;
+        parcial.varianza += cantidad * probabilidadFinal * (1.0 - probabilidadFinal);
+    }
+    
+    return parcial;
+}
+
+// Con umbral u, una persona incluida cuenta si su puntuación s cumple s >= u,
+// y entonces su probabilidad final es base·s sin importar u. Cada bloque
+// acumula a las personas incluidas por hoja (la hoja fija s); un umbral suma
+// después las hojas con puntuación >= u, de la más alta a la más baja.
+bool AnalizadorTrafico::recorrerCurva(const ColumnasPoblacion& columnas,
+                                     const ConsultaResuelta& consulta,
+                                     const QVector<double>& umbrales,
+                                     double nivelConfianza,
+                                     QVector<PuntoAlcance>& curva,
+                                     ControlAnalisis* control)
+{
+    const UpliftModel::CompiledTree& arbol = modeloUplift->compiledTree();
+    const std::vector<double>& hojas = modeloUplift->compiledTree().distinctLeafScores();
+    const std::size_t numHojas = hojas.size();
+    
+    const std::size_t numBloques = (columnas.filas + TAMANO_BLOQUE - 1) / TAMANO_BLOQUE;
+    std::vector<ConteoParcial> parciales(numBloques * numHojas);
+    std::atomic<std::size_t> bloquesHechos{0};
+    
+    GrupoHilos::global().ejecutar(numBloques, [&](std::size_t bloque) {
+        if (control && control->estaCancelado()) {
+            return;
+        }
+        const std::size_t inicio = bloque * TAMANO_BLOQUE;
+        const std::size_t fin = std::min(inicio + TAMANO_BLOQUE, columnas.filas);
+        std::vector<double> puntuaciones(fin - inicio);
+        arbol.evaluateRange(columnas, inicio, fin - inicio, puntuaciones.data());
+        ConteoParcial* porHoja = &parciales[bloque * numHojas];
+        
+        for (std::size_t fila = inicio; fila < fin; ++fila) {
+            if (!cumpleCriterioInclusion(columnas, fila, consulta)) {
+                continue;
+            }
+            const double score = puntuaciones[fila - inicio];
+            const std::size_t hoja = std::min(static_cast<std::size_t>(
+                std::lower_bound(hojas.begin(), hojas.end(), score) - hojas.begin()), numHojas - 1);
+            ConteoParcial& parcial = porHoja[hoja];
+            parcial.incluidos++;
+            
+            // Sin umbral: la probabilidad que tendría con cualquier umbral <= score
+            double probabilidadFinal = obtenerProbabilidadBase(columnas.edad[fila], consulta) * score;
+            if (probabilidadFinal <= 0.0) {
+                continue;
+            }
+            parcial.elegibles++;
+            parcial.esperado += probabilidadFinal;
+            parcial.varianza += probabilidadFinal * (1.0 - probabilidadFinal);
+            if (sortearPersona(columnas.id[fila]) < probabilidadFinal) {
+                parcial.influenciables++;
+            }
+        }
+        
+        std::size_t hechos = bloquesHechos.fetch_add(1) + 1;
+        if (control && control->progreso) {
+            control->progreso(hechos, numBloques);
+        }
+    }, numeroHilos);
+    
+    // Con bloques omitidos la curva no vale: se devuelve vacía
+    curva.clear();
+    if (control && control->estaCancelado()) {
+        return false;
+    }
+    
+    // Totales por hoja en orden de bloque
+    std::vector<ConteoParcial> porHoja(numHojas);
+    for (std::size_t hoja = 0; hoja < numHojas; ++hoja) {
+        for (std::size_t bloque = 0; bloque < numBloques; ++bloque) {
+            porHoja[hoja].acumular(parciales[bloque * numHojas + hoja]);
+        }
+    }
+    curva = construirCurva(porHoja, hojas, umbrales, nivelConfianza);
+    return true;
+}
+
+// Acumula desde la hoja más alta: desde[h] son las personas con puntuación >= hojas[h]
+QVector<PuntoAlcance> AnalizadorTrafico::construirCurva(const std::vector<ConteoParcial>& porHoja,
+                                                        const std::vector<double>& hojas,
+                                                        const QVector<double>& umbrales,
+                                                        double nivelConfianza) const
+{
+    std::vector<ConteoParcial> desde(hojas.size() + 1);
+    for (std::size_t hoja = hojas.size(); hoja-- > 0; ) {
+        desde[hoja] = desde[hoja + 1];
+        desde[hoja].acumular(porHoja[hoja]);
+    }
+    
+    QVector<PuntoAlcance> curva;
+    curva.reserve(umbrales.size());
+    for (double umbral : umbrales) {
+        const std::size_t hoja = static_cast<std::size_t>(
+            std::lower_bound(hojas.begin(), hojas.end(), umbral) - hojas.begin());
+        const ConteoParcial& total = desde[hoja];
+        curva.push_back(PuntoAlcance(umbral, static_cast<int>(total.influenciables),
+                                     construirEstimacion(total, nivelConfianza)));
+    }
+    return curva;
+}
+
+// Como recorrerCurva, con las personas acumuladas además por edad. La
+// población se parte en un número fijo de tramos de bloques contiguos, así
+// que la suma no depende del número de hilos y la memoria de los parciales
+// no crece con la población.
+bool AnalizadorTrafico::recorrerPorEdad(const ColumnasPoblacion& columnas,
+                                        const ConsultaResuelta& consulta,
+                                        ConteosPorEdad& conteos,
+                                        ControlAnalisis* control)
+{
+    static constexpr std::size_t TRAMOS = 64;
+    const UpliftModel::CompiledTree& arbol = modeloUplift->compiledTree();
+    const std::vector<double>& hojas = modeloUplift->compiledTree().distinctLeafScores();
+    const std::size_t numHojas = hojas.size();
+    
+    const std::size_t numBloques = (columnas.filas + TAMANO_BLOQUE - 1) / TAMANO_BLOQUE;
+    const std::size_t numTramos = std::min(TRAMOS, numBloques);
+    std::vector<ConteosPorEdad> parciales(numTramos);
+    std::atomic<std::size_t> bloquesHechos{0};
+    
+    GrupoHilos::global().ejecutar(numTramos, [&](std::size_t tramo) {
+        ConteosPorEdad& parcial = parciales[tramo];
+        parcial.reiniciar(hojas);
+        std::vector<double> puntuaciones(TAMANO_BLOQUE);
+        
+        for (std::size_t bloque = tramo * numBloques / numTramos;
+             bloque < (tramo + 1) * numBloques / numTramos; ++bloque) {
+            if (control && control->estaCancelado()) {
+                return;
+            }
+            const std::size_t inicio = bloque * TAMANO_BLOQUE;
+            const std::size_t fin = std::min(inicio + TAMANO_BLOQUE, columnas.filas);
+            arbol.evaluateRange(columnas, inicio, fin - inicio, puntuaciones.data());
+            
+            for (std::size_t fila = inicio; fila < fin; ++fila) {
+                if (!cumpleCriterioInclusion(columnas, fila, consulta)) {
+                    continue;
+                }
+                const double score = puntuaciones[fila - inicio];
+                const std::size_t hoja = std::min(static_cast<std::size_t>(
+                    std::lower_bound(hojas.begin(), hojas.end(), score) - hojas.begin()), numHojas - 1);
+                ConteosPorEdad::Celda& celda = parcial.celda(columnas.edad[fila], hoja);
+                celda.incluidos++;
+                
+                double probabilidadFinal = obtenerProbabilidadBase(columnas.edad[fila], consulta) * score;
+                if (probabilidadFinal <= 0.0) {
+                    continue;
+                }
+                celda.elegibles++;
+                celda.esperado += probabilidadFinal;
+                celda.varianza += probabilidadFinal * (1.0 - probabilidadFinal);
+                if (sortearPersona(columnas.id[fila]) < probabilidadFinal) {
+                    celda.influenciables++;
+                }
+            }
+            
+            std::size_t hechos = bloquesHechos.fetch_add(1) + 1;
+            if (control && control->progreso) {
+                control->progreso(hechos, numBloques);
+            }
+        }
+    }, numeroHilos);
+    
+    if (control && control->estaCancelado()) {
+        return false;
+    }
+    
+    // Combinar en orden de tramo
+    conteos.reiniciar(hojas);
+    for (const ConteosPorEdad& parcial : parciales) {
+        conteos.acumular(parcial);
+    }
+    return true;
+}
+
+AnalizadorTrafico::ConteoParcial AnalizadorTrafico::recorrerPorBloques(const ColumnasPoblacion& columnas,
+                                                                      const ConsultaResuelta& consulta,
+                                                                      ModoConteo modo,
+                                                                      double umbralInfluenciabilidad,
+                                                                      ControlAnalisis* control,
+                                                                      bool informarProgreso)
+{
+    const std::size_t numBloques = (columnas.filas + TAMANO_BLOQUE - 1) / TAMANO_BLOQUE;
+    std::vector<ConteoParcial> parciales(numBloques);
+    std::atomic<std::size_t> bloquesHechos{0};
+    
+    GrupoHilos::global().ejecutar(numBloques, [&](std::size_t bloque) {
+        if (control && control->estaCancelado()) {
+            return;
+        }
+        parciales[bloque] = contarBloque(columnas, consulta, bloque, modo, umbralInfluenciabilidad);
+        
+        std::size_t hechos = bloquesHechos.fetch_add(1) + 1;
+        if (informarProgreso && control && control->progreso) {
+            control->progreso(hechos, numBloques);
+        }
+    }, numeroHilos);
+    
+    // Combinar en orden de bloque
+    ConteoParcial total;
+    for (const ConteoParcial& parcial : parciales) {
+        total.acumular(parcial);
+    }
+    return total;
+}
+
+bool AnalizadorTrafico::recorrerFuente(FuentePoblacion& fuente,
+                                      ConsultaResuelta consulta,
+                                      const QString& espacio,
+                                      ModoConteo modo,
+                                      double umbralInfluenciabilidad,
+                                      ConteoParcial& resultado,
+                                      ControlAnalisis* control)
+{
+    // Dos lotes que se alternan entre el hilo de lectura y el de análisis
+    PoblacionColumnar lotes[2];
+    qint64 posiciones[2] = {0, 0};
+    std::deque<int> libres = {0, 1};
+    std::deque<int> llenos;
+    std::mutex mutex;
+    std::condition_variable cambio;
+    bool leido = false;
+    bool detener = false;
+    const qint64 total = fuente.total();
+    
+    // El análisis ocupa el grupo global; la lectura usa uno propio para
+    // preparar el lote siguiente al mismo tiempo
+    GrupoHilos hilosLectura(GrupoHilos::global().tamano());
+    fuente.establecerHilos(&hilosLectura);
+    
+    std::thread lector([&]() {
+        while (true) {
+            int lote;
+            {
+                std::unique_lock<std::mutex> bloqueo(mutex);
+                cambio.wait(bloqueo, [&]() { return !libres.empty() || detener; });
+                if (detener) {
+                    break;
+                }
+                lote = libres.front();
+                libres.pop_front();
+            }
+            
+            bool hayFilas = fuente.leerLote(lotes[lote]);
+            posiciones[lote] = fuente.posicion();
+            if (!hayFilas) {
+                break;
+            }
+            {
+                std::lock_guard<std::mutex> bloqueo(mutex);
+                llenos.push_back(lote);
+            }
+            cambio.notify_all();
+        }
+        {
+            std::lock_guard<std::mutex> bloqueo(mutex);
+            leido = true;
+        }
+        cambio.notify_all();
+    });
+    
+    // Los conteos de cada lote se suman en el orden de lectura
+    resultado = ConteoParcial();
+    while (true) {
+        int lote;
+        {
+            std::unique_lock<std::mutex> bloqueo(mutex);
+            cambio.wait(bloqueo, [&]() { return !llenos.empty() || leido; });
+            if (llenos.empty()) {
+                break;
+            }
+            lote = llenos.front();
+            llenos.pop_front();
+        }
+        
+        const bool cancelado = control && control->estaCancelado();
+        if (!cancelado) {
+            if (consulta.esGeografico && consulta.espacio < 0) {
+                consulta.espacio = Catalogo::lugares().buscar(espacio);
+            }
+            resultado.acumular(recorrerPorBloques(lotes[lote].obtenerColumnas(), consulta, modo,
+                                                  umbralInfluenciabilidad, control, false));
+            if (control && control->progreso) {
+                control->progreso(static_cast<std::size_t>(posiciones[lote]), static_cast<std::size_t>(total));
+            }
+        }
+        {
+            std::lock_guard<std::mutex> bloqueo(mutex);
+            libres.push_back(lote);
+            detener = detener || cancelado;
+        }
+        cambio.notify_all();
+    }
+    lector.join();
+    fuente.establecerHilos(nullptr);
+    
+    // leerLote devuelve false tanto al terminar como ante un error
+    if (!fuente.error().isEmpty()) {
+        return false;
+    }
+    return !(control && control->estaCancelado());
+}
+
+void AnalizadorTrafico::ConteoParcial::acumular(const ConteoParcial& otro)
+{
+    incluidos += otro.incluidos;
+    influenciables += otro.influenciables;
+    elegibles += otro.elegibles;
+    esperado += otro.esperado;
+    varianza += otro.varianza;
+}
+
+// Aproximación racional de Acklam (error relativo < 1.2e-9)
+double AnalizadorTrafico::cuantilNormal(double probabilidad)
+{
+    static const double a[] = { -3.969683028665376e+01,  2.209460984245205e+02,
+                                -2.759285104469687e+02,  1.383577518672690e+02,
+                                -3.066479806614716e+01,  2.506628277459239e+00 };
+    static const double b[] = { -5.447609879822406e+01,  1.615858368580409e+02,
+                                -1.556989798598866e+02,  6.680131188771972e+01,
+                                -1.328068155288572e+01 };
+    static const double c[] = { -7.784894002430293e-03, -3.223964580411365e-01,
+                                -2.400758277161838e+00, -2.549732539343734e+00,
+                                 4.374664141464968e+00,  2.938163982698783e+00 };
+    static const double d[] = {  7.784695709041462e-03,  3.224671290700398e-01,
+                                 2.445134137142996e+00,  3.754408661907416e+00 };
+    const double bajo = 0.02425;
+    
+    if (probabilidad <= 0.0) return -std::numeric_limits<double>::infinity();
+    if (probabilidad >= 1.0) return std::numeric_limits<double>::infinity();
+    
+    if (probabilidad < bajo) {
+        double q = std::sqrt(-2.0 * std::log(probabilidad));
+        return (((((c[0] * q + c[1]) * q + c[2]) * q + c[3]) * q + c[4]) * q + c[5]) /
+               ((((d[0] * q + d[1]) * q + d[2]) * q + d[3]) * q + 1.0);
+    }
+    if (probabilidad > 1.0 - bajo) {
+        double q = std::sqrt(-2.0 * std::log(1.0 - probabilidad));
+        return -(((((c[0] * q + c[1]) * q + c[2]) * q + c[3]) * q + c[4]) * q + c[5]) /
+                ((((d[0] * q + d[1]) * q + d[2]) * q + d[3]) * q + 1.0);
+    }
+    
+    double q = probabilidad - 0.5;
+    double r = q * q;
+    return (((((a[0] * r + a[1]) * r + a[2]) * r + a[3]) * r + a[4]) * r + a[5]) * q /
+           (((((b[0] * r + b[1]) * r + b[2]) * r + b[3]) * r + b[4]) * r + 1.0);
 }
 
 // Obtener estadísticas del modelo de uplift para una población
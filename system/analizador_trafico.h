@@ -2,12 +2,33 @@
 #define ANALIZADOR_TRAFICO_H
 
 #include "../data_estructures/persona.h"
+#include "../data_estructures/poblacion_columnar.h"
+#include "../data_estructures/fuente_poblacion.h"
+#include "../data_estructures/indice_distritos.h"
+#include "../data_estructures/indice_bitmap.h"
 #include "uplifting_model.h"
+#include "cubo_poblacion.h"
+#include "conteos_por_edad.h"
+#include "../data_estructures/generador_aleatorio.h"
 #include <QVector>
 #include <QString>
 #include <QMap>
 #include <QRandomGenerator>
 #include <memory>
+#include <atomic>
+#include <functional>
+
+// Control de un análisis en curso. Se comparte entre el hilo que lanza el
+// análisis y los hilos que lo recorren: progreso se invoca al terminar cada
+// bloque (desde cualquier hilo) y cancelar() hace que los bloques pendientes
+// se omitan. Las funciones que lo reciben devuelven false si se canceló.
+struct ControlAnalisis {
+    std::function<void(std::size_t bloquesHechos, std::size_t totalBloques)> progreso;
+    std::atomic<bool> cancelado{false};
+    
+    void cancelar() { cancelado.store(true); }
+    bool estaCancelado() const { return cancelado.load(std::memory_order_relaxed); }
+};
 
 class AnalizadorTrafico
 {
@@ -29,6 +50,261 @@ public:
                                 const QString& tipoEspacio,
                                 double umbralInfluenciabilidad = 0.5);
     
+    // Variantes que recorren directamente una población columnar. Las que
+    // devuelven bool reciben un ControlAnalisis: informan su progreso, pueden
+    // cancelarse y devuelven false si se canceló, con el resultado incompleto.
+    int calcularTrafico(const PoblacionColumnar& poblacion,
+                       const ClienteIdeal& cliente,
+                       const QString& espacio,
+                       const QString& producto,
+                       const QString& tipoEspacio);
+    
+    bool calcularTrafico(const PoblacionColumnar& poblacion,
+                        const ClienteIdeal& cliente,
+                        const QString& espacio,
+                        const QString& producto,
+                        const QString& tipoEspacio,
+                        int& trafico,
+                        ControlAnalisis* control = nullptr);
+    
+    int calcularTraficoConUplift(const PoblacionColumnar& poblacion,
+                                const ClienteIdeal& cliente,
+                                const QString& espacio,
+                                const QString& producto,
+                                const QString& tipoEspacio,
+                                double umbralInfluenciabilidad = 0.5);
+    
+    bool calcularTraficoConUplift(const PoblacionColumnar& poblacion,
+                                 const ClienteIdeal& cliente,
+                                 const QString& espacio,
+                                 const QString& producto,
+                                 const QString& tipoEspacio,
+                                 int& trafico,
+                                 double umbralInfluenciabilidad = 0.5,
+                                 ControlAnalisis* control = nullptr);
+    
+    // Modo analítico: valor esperado Σ probAcceso·probConversion·score,
+    // su varianza y un intervalo de confianza, en una pasada y sin sorteos
+    EstimacionTrafico calcularTraficoEsperado(const PoblacionColumnar& poblacion,
+                                             const ClienteIdeal& cliente,
+                                             const QString& espacio,
+                                             const QString& producto,
+                                             const QString& tipoEspacio,
+                                             double umbralInfluenciabilidad = 0.5,
+                                             double nivelConfianza = 0.95);
+    
+    bool calcularTraficoEsperado(const PoblacionColumnar& poblacion,
+                                const ClienteIdeal& cliente,
+                                const QString& espacio,
+                                const QString& producto,
+                                const QString& tipoEspacio,
+                                EstimacionTrafico& estimacion,
+                                double umbralInfluenciabilidad = 0.5,
+                                double nivelConfianza = 0.95,
+                                ControlAnalisis* control = nullptr);
+    
+    // Variantes que recorren la población a través del índice por distrito:
+    // una consulta geográfica solo toca las filas de su distrito dentro del
+    // rango de edad del cliente; las demás recorren la población completa
+    int calcularTrafico(const IndiceDistritos& indice,
+                       const ClienteIdeal& cliente,
+                       const QString& espacio,
+                       const QString& producto,
+                       const QString& tipoEspacio);
+    
+    bool calcularTrafico(const IndiceDistritos& indice,
+                        const ClienteIdeal& cliente,
+                        const QString& espacio,
+                        const QString& producto,
+                        const QString& tipoEspacio,
+                        int& trafico,
+                        ControlAnalisis* control = nullptr);
+    
+    int calcularTraficoConUplift(const IndiceDistritos& indice,
+                                const ClienteIdeal& cliente,
+                                const QString& espacio,
+                                const QString& producto,
+                                const QString& tipoEspacio,
+                                double umbralInfluenciabilidad = 0.5);
+    
+    bool calcularTraficoConUplift(const IndiceDistritos& indice,
+                                 const ClienteIdeal& cliente,
+                                 const QString& espacio,
+                                 const QString& producto,
+                                 const QString& tipoEspacio,
+                                 int& trafico,
+                                 double umbralInfluenciabilidad = 0.5,
+                                 ControlAnalisis* control = nullptr);
+    
+    EstimacionTrafico calcularTraficoEsperado(const IndiceDistritos& indice,
+                                             const ClienteIdeal& cliente,
+                                             const QString& espacio,
+                                             const QString& producto,
+                                             const QString& tipoEspacio,
+                                             double umbralInfluenciabilidad = 0.5,
+                                             double nivelConfianza = 0.95);
+    
+    bool calcularTraficoEsperado(const IndiceDistritos& indice,
+                                const ClienteIdeal& cliente,
+                                const QString& espacio,
+                                const QString& producto,
+                                const QString& tipoEspacio,
+                                EstimacionTrafico& estimacion,
+                                double umbralInfluenciabilidad = 0.5,
+                                double nivelConfianza = 0.95,
+                                ControlAnalisis* control = nullptr);
+    
+    // Tráfico sobre el índice de mapas de bits: el perfil del cliente, el
+    // espacio y los umbrales por edad del producto se traducen a AND/OR de
+    // mapas y el resultado sale de contar bits, sin recorrer personas. Igual
+    // a calcularTrafico sobre la población con la que se construyó el índice.
+    int calcularTrafico(const IndiceBitmap& indice, 
+                       const ClienteIdeal& cliente, 
+                       const QString& espacio, 
+                       const QString& producto,
+                       const QString& tipoEspacio);
+    
+    // Variantes que leen la población de un archivo por lotes (ver
+    // FuentePoblacion), con la fuente ya abierta. Un hilo lee el lote siguiente
+    // mientras se analiza el actual y los conteos de cada lote se suman al
+    // final, así que la memoria no crece con el archivo. El resultado coincide
+    // con el de la población cargada entera (salvo redondeo en el modo
+    // esperado); el progreso se informa en las unidades de la fuente.
+    // Devuelven false si la lectura falla (el motivo queda en fuente.error())
+    // o si el análisis se canceló.
+    bool calcularTrafico(FuentePoblacion& fuente, 
+                         const ClienteIdeal& cliente, 
+                         const QString& espacio, 
+                         const QString& producto,
+                         const QString& tipoEspacio,
+                         int& trafico,
+                         ControlAnalisis* control = nullptr);
+    
+    bool calcularTraficoConUplift(FuentePoblacion& fuente, 
+                                  const ClienteIdeal& cliente, 
+                                  const QString& espacio, 
+                                  const QString& producto,
+                                  const QString& tipoEspacio,
+                                  int& trafico,
+                                  double umbralInfluenciabilidad = 0.5,
+                                  ControlAnalisis* control = nullptr);
+    
+    bool calcularTraficoEsperado(FuentePoblacion& fuente, 
+                                 const ClienteIdeal& cliente, 
+                                 const QString& espacio, 
+                                 const QString& producto,
+                                 const QString& tipoEspacio,
+                                 EstimacionTrafico& estimacion,
+                                 double umbralInfluenciabilidad = 0.5,
+                                 double nivelConfianza = 0.95,
+                                 ControlAnalisis* control = nullptr);
+    
+    // Consultas repetidas sobre una misma población: el cubo se construye una
+    // vez y cada consulta suma sus celdas en lugar de recorrer personas. El
+    // modo por muestreo necesita el sorteo de cada persona y no tiene variante
+    // con cubo; la estimación coincide con la de la población salvo redondeo.
+    bool construirCubo(const PoblacionColumnar& poblacion, CuboPoblacion& cubo) const;
+    
+    int calcularTrafico(const CuboPoblacion& cubo, 
+                       const ClienteIdeal& cliente, 
+                       const QString& espacio, 
+                       const QString& producto,
+                       const QString& tipoEspacio);
+    
+    EstimacionTrafico calcularTraficoEsperado(const CuboPoblacion& cubo, 
+                                             const ClienteIdeal& cliente, 
+                                             const QString& espacio, 
+                                             const QString& producto,
+                                             const QString& tipoEspacio,
+                                             double umbralInfluenciabilidad = 0.5,
+                                             double nivelConfianza = 0.95);
+    
+    // Curva de alcance: el resultado de calcularTraficoConUplift y de
+    // calcularTraficoEsperado para cada umbral, en una sola pasada. El árbol
+    // solo emite unas pocas puntuaciones de hoja, así que basta con acumular
+    // a las personas por hoja y sumar las hojas que alcanza cada umbral.
+    // Un punto por umbral, en el orden recibido; con control, si se cancela
+    // devuelve false y la curva queda vacía.
+    QVector<PuntoAlcance> calcularCurvaAlcance(const PoblacionColumnar& poblacion,
+                                               const ClienteIdeal& cliente,
+                                               const QString& espacio,
+                                               const QString& producto,
+                                               const QString& tipoEspacio,
+                                               const QVector<double>& umbrales,
+                                               double nivelConfianza = 0.95);
+    
+    bool calcularCurvaAlcance(const PoblacionColumnar& poblacion,
+                              const ClienteIdeal& cliente,
+                              const QString& espacio,
+                              const QString& producto,
+                              const QString& tipoEspacio,
+                              const QVector<double>& umbrales,
+                              QVector<PuntoAlcance>& curva,
+                              double nivelConfianza = 0.95,
+                              ControlAnalisis* control = nullptr);
+    
+    QVector<PuntoAlcance> calcularCurvaAlcance(const IndiceDistritos& indice,
+                                               const ClienteIdeal& cliente,
+                                               const QString& espacio,
+                                               const QString& producto,
+                                               const QString& tipoEspacio,
+                                               const QVector<double>& umbrales,
+                                               double nivelConfianza = 0.95);
+    
+    bool calcularCurvaAlcance(const IndiceDistritos& indice,
+                              const ClienteIdeal& cliente,
+                              const QString& espacio,
+                              const QString& producto,
+                              const QString& tipoEspacio,
+                              const QVector<double>& umbrales,
+                              QVector<PuntoAlcance>& curva,
+                              double nivelConfianza = 0.95,
+                              ControlAnalisis* control = nullptr);
+    
+    // Análisis incremental: una pasada deja los conteos de la consulta por
+    // edad y hoja, ignorando el rango de edad del cliente; después cada
+    // rango de edad y cada umbral se responden sin recorrer la población
+    // (ver CacheConteos). Devuelve false si el análisis se canceló.
+    bool calcularConteosPorEdad(const PoblacionColumnar& poblacion,
+                                const ClienteIdeal& cliente,
+                                const QString& espacio,
+                                const QString& producto,
+                                const QString& tipoEspacio,
+                                ConteosPorEdad& conteos,
+                                ControlAnalisis* control = nullptr);
+    
+    bool calcularConteosPorEdad(const IndiceDistritos& indice,
+                                const ClienteIdeal& cliente,
+                                const QString& espacio,
+                                const QString& producto,
+                                const QString& tipoEspacio,
+                                ConteosPorEdad& conteos,
+                                ControlAnalisis* control = nullptr);
+    
+    // Curva de alcance del rango de edad del cliente a partir de los conteos
+    QVector<PuntoAlcance> calcularCurvaAlcance(const ConteosPorEdad& conteos,
+                                               const ClienteIdeal& cliente,
+                                               const QVector<double>& umbrales,
+                                               double nivelConfianza = 0.95) const;
+    
+    // Varios escenarios en una sola pasada: la puntuación de uplift y el
+    // sorteo de cada persona se calculan una vez y se reparten entre todos.
+    // El resultado i corresponde al escenario i y coincide con llamar por
+    // separado a calcularTrafico, calcularTraficoConUplift y
+    // calcularTraficoEsperado (salvo redondeo en el valor esperado).
+    // Devuelve false, sin resultados, si el análisis se canceló.
+    bool calcularEscenarios(const PoblacionColumnar& poblacion,
+                            const QVector<EscenarioTrafico>& escenarios,
+                            QVector<ResultadoEscenario>& resultados,
+                            double nivelConfianza = 0.95,
+                            ControlAnalisis* control = nullptr);
+    
+    // Los mismos escenarios sumando celdas del cubo: tráfico y estimación
+    // sin recorrer personas; traficoConUplift queda en SIN_MUESTREO
+    QVector<ResultadoEscenario> calcularEscenarios(const CuboPoblacion& cubo,
+                                                   const QVector<EscenarioTrafico>& escenarios,
+                                                   double nivelConfianza = 0.95);
+    
     // Criterios de inclusión
     bool cumpleCriterioInclusion(const Persona& persona, 
                                 const ClienteIdeal& cliente,
@@ -43,6 +319,19 @@ public:
     // Configuración de productos
     void configurarProductos();
     
+    // Ejecución paralela: la población se recorre en bloques de tamaño fijo.
+    // El sorteo de cada persona depende solo de (semilla, id), de modo que
+    // el resultado no depende del número de hilos ni del orden de evaluación.
+    // Sin establecerSemilla se usa SEMILLA_POR_DEFECTO: dos ejecuciones
+    // iguales dan el mismo tráfico sorteado.
+    void establecerNumeroHilos(int hilos);      // 0 = todos los disponibles, 1 = serial
+    int obtenerNumeroHilos() const { return numeroHilos; }
+    void establecerSemilla(quint64 nuevaSemilla);
+    quint64 obtenerSemilla() const { return semilla; }
+    
+    static const std::size_t TAMANO_BLOQUE;
+    static const quint64 SEMILLA_POR_DEFECTO;
+    
     // Métodos para análisis de uplift
     QMap<QString, double> obtenerEstadisticasUplift(const QVector<Persona>& poblacion);
     QVector<Persona> filtrarPorInfluenciabilidad(const QVector<Persona>& poblacion, 
@@ -56,6 +345,10 @@ private:
     // Modelo de uplift
     std::unique_ptr<UpliftModel::UpliftTreeModel> modeloUplift;
     
+    // Parámetros de ejecución
+    int numeroHilos;
+    quint64 semilla;
+    
     // Constantes demográficas
     static const double PROB_ACCESO_JOVENES;
     static const double PROB_ACCESO_MILLENNIALS;
@@ -76,6 +369,125 @@ private:
     // Métodos auxiliares
     enum GrupoEtario { JOVENES, MILLENNIALS, ADULTOS, MAYORES };
     GrupoEtario obtenerGrupoEtario(int edad);
+    
+    // Una entrada por cada valor posible del byte de edad
+    static constexpr int TABLA_EDADES = 256;
+    
+    // Probabilidades por edad, calculadas una vez: acceso y conversión
+    // para productos generales [0] y digitales [1]
+    double tablaAcceso[TABLA_EDADES];
+    double tablaConversion[2][TABLA_EDADES];
+    void construirTablasEdad();
+    
+    // Consulta con los textos ya resueltos a códigos del Catalogo
+    struct ConsultaResuelta {
+        int edadMin;
+        int edadMax;
+        quint8 sexo;                // CodigoSexo; SEXO_CUALQUIERA no filtra
+        bool requiereInternet;
+        bool esGeografico;
+        int espacio;                // Código de distrito o plataforma; -1 si no existe
+        bool productoDigital;
+        bool productoVisual;
+        bool aplicaProbAcceso;      // Solo el tipo "Digital" pondera el acceso por edad
+        
+        // Tablas por edad para la clase de producto de esta consulta
+        bool edadAdmitida[TABLA_EDADES];        // Rango del cliente y umbrales de acceso y conversión
+        double probabilidadBase[TABLA_EDADES];  // probAcceso·probConversion; 0 bajo los umbrales
+    };
+    
+    ConsultaResuelta resolverConsulta(const ClienteIdeal& cliente,
+                                      const QString& espacio,
+                                      const QString& producto,
+                                      const QString& tipoEspacio) const;
+    bool cumpleCriterioInclusion(const Persona& persona, const ConsultaResuelta& consulta);
+    bool cumpleCriterioInclusion(const ColumnasPoblacion& columnas,
+                                 std::size_t fila,
+                                 const ConsultaResuelta& consulta);
+    double obtenerProbabilidadConversion(int edad, bool esDigital);
+    bool admiteEdad(int edad, const ConsultaResuelta& consulta);
+    double obtenerProbabilidadBase(int edad, const ConsultaResuelta& consulta);
+    
+    // Probabilidad final de una persona que ya cumple los criterios de inclusión;
+    // 0 si su puntuación de uplift no alcanza el umbral
+    double obtenerProbabilidadFinal(int edad, double scoreInfluenciabilidad,
+                                    const ConsultaResuelta& consulta,
+                                    double umbralInfluenciabilidad);
+    double sortearPersona(int idPersona) const;
+    
+    // Qué acumula un recorrido de la población
+    enum ModoConteo { SOLO_INCLUSION, MUESTREO, ESPERADO };
+    
+    // Conteos parciales de un bloque de la población
+    struct ConteoParcial {
+        qint64 incluidos = 0;
+        qint64 influenciables = 0;
+        qint64 elegibles = 0;
+        double esperado = 0.0;
+        double varianza = 0.0;
+        
+        void acumular(const ConteoParcial& otro);
+    };
+    
+    ConteoParcial contarBloque(const ColumnasPoblacion& columnas,
+                               const ConsultaResuelta& consulta,
+                               std::size_t bloque,
+                               ModoConteo modo,
+                               double umbralInfluenciabilidad);
+    ConteoParcial recorrerPorBloques(const ColumnasPoblacion& columnas,
+                                     const ConsultaResuelta& consulta,
+                                     ModoConteo modo,
+                                     double umbralInfluenciabilidad,
+                                     ControlAnalisis* control,
+                                     bool informarProgreso = true);
+    // Conteos de un bloque en los tres modos, uno por escenario
+    void contarBloqueEscenarios(const ColumnasPoblacion& columnas,
+                                const std::vector<ConsultaResuelta>& consultas,
+                                const QVector<EscenarioTrafico>& escenarios,
+                                std::size_t bloque,
+                                ConteoParcial* parciales);
+    // False y curva vacía si se canceló
+    bool recorrerCurva(const ColumnasPoblacion& columnas,
+                       const ConsultaResuelta& consulta,
+                       const QVector<double>& umbrales,
+                       double nivelConfianza,
+                       QVector<PuntoAlcance>& curva,
+                       ControlAnalisis* control);
+    bool recorrerPorEdad(const ColumnasPoblacion& columnas,
+                         const ConsultaResuelta& consulta,
+                         ConteosPorEdad& conteos,
+                         ControlAnalisis* control);
+    
+    // Un punto por umbral a partir de los totales de cada hoja
+    QVector<PuntoAlcance> construirCurva(const std::vector<ConteoParcial>& porHoja,
+                                         const std::vector<double>& hojas,
+                                         const QVector<double>& umbrales,
+                                         double nivelConfianza) const;
+    // Filas que puede admitir una consulta: con espacio geográfico, las de su
+    // distrito y rango de edad, copiadas a copia si el índice no es directo
+    ColumnasPoblacion seleccionarFilas(const IndiceDistritos& indice,
+                                       const ConsultaResuelta& consulta,
+                                       PoblacionColumnar& copia) const;
+    IndiceBitmap::ConsultaBits compilarConsulta(const IndiceBitmap& indice,
+                                                const ConsultaResuelta& consulta) const;
+    ConteoParcial contarCeldas(const CuboPoblacion& cubo,
+                               const ConsultaResuelta& consulta,
+                               ModoConteo modo,
+                               double umbralInfluenciabilidad);
+    // False si la fuente informa un error o si se canceló. Un distrito que el
+    // catálogo aún no conoce no coincide con ninguna fila; se vuelve a buscar
+    // (sin internarlo) tras cada lote, por si la lectura del archivo lo agregó
+    bool recorrerFuente(FuentePoblacion& fuente,
+                        ConsultaResuelta consulta,
+                        const QString& espacio,
+                        ModoConteo modo,
+                        double umbralInfluenciabilidad,
+                        ConteoParcial& resultado,
+                        ControlAnalisis* control);
+    EstimacionTrafico construirEstimacion(const ConteoParcial& total, double nivelConfianza) const;
+    
+    // Cuantil de la normal estándar para construir intervalos de confianza
+    static double cuantilNormal(double probabilidad);
 };
 
 #endif // ANALIZADOR_TRAFICO_H
@@ -0,0 +1,60 @@
+#include "conteos_por_edad.h"
+
+void ConteosPorEdad::Celda::acumular(const Celda& otra)
+{
+    incluidos += otra.incluidos;
+    influenciables += otra.influenciables;
+    elegibles += otra.elegibles;
+    esperado += otra.esperado;
+    varianza += otra.varianza;
+}
+
+void ConteosPorEdad::reiniciar(const std::vector<double>& puntuacionesHoja)
+{
+    hojas = puntuacionesHoja;
+    celdas.assign(EDADES * hojas.size(), Celda());
+}
+
+void ConteosPorEdad::acumular(const ConteosPorEdad& otros)
+{
+    for (std::size_t i = 0; i < celdas.size(); ++i) {
+        celdas[i].acumular(otros.celdas[i]);
+    }
+}
+
+QString CacheConteos::clave(const ClienteIdeal& cliente, const QString& espacio, const QString& producto,
+                            const QString& tipoEspacio, quint64 semilla)
+{
+    return QString("%1|%2|%3|%4|%5|%6")
+        .arg(cliente.sexo).arg(cliente.requiereInternet ? 1 : 0)
+        .arg(espacio).arg(producto).arg(tipoEspacio).arg(semilla);
+}
+
+std::shared_ptr<const ConteosPorEdad> CacheConteos::buscar(const QString& clave)
+{
+    std::lock_guard<std::mutex> bloqueo(mutex);
+    std::shared_ptr<const ConteosPorEdad> conteos = entradas.value(clave);
+    if (conteos) {
+        orden.removeOne(clave);
+        orden.append(clave);
+    }
+    return conteos;
+}
+
+void CacheConteos::guardar(const QString& clave, std::shared_ptr<const ConteosPorEdad> conteos)
+{
+    std::lock_guard<std::mutex> bloqueo(mutex);
+    orden.removeOne(clave);
+    orden.append(clave);
+    entradas.insert(clave, std::move(conteos));
+    while (orden.size() > MAX_ENTRADAS) {
+        entradas.remove(orden.takeFirst());
+    }
+}
+
+void CacheConteos::limpiar()
+{
+    std::lock_guard<std::mutex> bloqueo(mutex);
+    entradas.clear();
+    orden.clear();
+}
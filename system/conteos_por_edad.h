@@ -0,0 +1,72 @@
+#ifndef CONTEOS_POR_EDAD_H
+#define CONTEOS_POR_EDAD_H
+
+#include "../data_estructures/persona.h"
+#include <QMap>
+#include <QString>
+#include <QVector>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// Conteos de una consulta desglosados por edad y por hoja del árbol de
+// uplift, con todas las edades admitidas. Cualquier rango de edad del
+// cliente y cualquier umbral se responden sumando celdas, sin volver a
+// recorrer la población: ampliar el rango solo suma las edades nuevas.
+class ConteosPorEdad
+{
+public:
+    static constexpr int EDADES = 256;
+
+    // Mismos acumulados que un recorrido de AnalizadorTrafico
+    struct Celda {
+        qint64 incluidos = 0;
+        qint64 influenciables = 0;
+        qint64 elegibles = 0;
+        double esperado = 0.0;
+        double varianza = 0.0;
+
+        void acumular(const Celda& otra);
+    };
+
+    // Deja todas las celdas a cero para las hojas dadas (en orden creciente)
+    void reiniciar(const std::vector<double>& puntuacionesHoja);
+
+    bool estaVacio() const { return celdas.empty(); }
+    std::size_t numHojas() const { return hojas.size(); }
+    const std::vector<double>& puntuaciones() const { return hojas; }
+
+    Celda& celda(int edad, std::size_t hoja) { return celdas[edad * hojas.size() + hoja]; }
+    const Celda& celda(int edad, std::size_t hoja) const { return celdas[edad * hojas.size() + hoja]; }
+
+    void acumular(const ConteosPorEdad& otros);
+
+private:
+    std::vector<double> hojas;
+    std::vector<Celda> celdas;           // celdas[edad * numHojas + hoja]
+};
+
+// Caché de ConteosPorEdad para la exploración interactiva. La clave reúne
+// todo lo que cambia los conteos salvo la edad y el umbral, que se resuelven
+// sobre los conteos guardados. Guarda los más recientes; hay que vaciarla
+// cuando cambia la población.
+class CacheConteos
+{
+public:
+    static constexpr int MAX_ENTRADAS = 32;
+
+    static QString clave(const ClienteIdeal& cliente, const QString& espacio, const QString& producto,
+                         const QString& tipoEspacio, quint64 semilla);
+
+    // Nulo si la clave no está
+    std::shared_ptr<const ConteosPorEdad> buscar(const QString& clave);
+    void guardar(const QString& clave, std::shared_ptr<const ConteosPorEdad> conteos);
+    void limpiar();
+
+private:
+    std::mutex mutex;
+    QMap<QString, std::shared_ptr<const ConteosPorEdad>> entradas;
+    QVector<QString> orden;              // De la menos a la más reciente
+};
+
+#endif // CONTEOS_POR_EDAD_H
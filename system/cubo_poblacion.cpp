@@ -0,0 +1,109 @@
+#include "cubo_poblacion.h"
+#include "grupo_hilos.h"
+#include <algorithm>
+#include <unordered_map>
+
+namespace {
+
+struct Celda {
+    qint64 cantidad = 0;
+    std::size_t primeraFila = 0;
+};
+
+using MapaCeldas = std::unordered_map<quint64, Celda>;
+
+} // namespace
+
+void CuboPoblacion::limpiar()
+{
+    representantes.limpiar();
+    cantidades.clear();
+    puntuaciones.clear();
+    total = 0;
+}
+
+bool CuboPoblacion::construir(const PoblacionColumnar& poblacion, const UpliftModel::CompiledTree& arbol)
+{
+    limpiar();
+
+    // Las hojas con la misma puntuación se funden en un solo tramo
+    const std::vector<double>& hojas = arbol.distinctLeafScores();
+    if (hojas.size() > MAX_HOJAS) {
+        return false;
+    }
+
+    // Clave: edad (8 bits), sexo (8), acceso (1), distrito (16) y tramo del árbol
+    const ColumnasPoblacion columnas = poblacion.obtenerColumnas();
+    auto clave = [&](std::size_t fila, double puntuacion) {
+        const quint64 tramo = static_cast<quint64>(
+            std::lower_bound(hojas.begin(), hojas.end(), puntuacion) - hojas.begin());
+        return static_cast<quint64>(columnas.edad[fila]) |
+               static_cast<quint64>(columnas.sexo[fila]) << 8 |
+               static_cast<quint64>(columnas.accesoInternet[fila] != 0) << 16 |
+               static_cast<quint64>(columnas.distrito[fila]) << 17 |
+               tramo << 33;
+    };
+
+    // Cada bloque agrupa por su cuenta; luego se combinan en orden de bloque
+    const std::size_t numBloques = (columnas.filas + FILAS_POR_BLOQUE - 1) / FILAS_POR_BLOQUE;
+    std::vector<MapaCeldas> parciales(numBloques);
+    GrupoHilos::global().ejecutar(numBloques, [&](std::size_t bloque) {
+        const std::size_t inicio = bloque * FILAS_POR_BLOQUE;
+        const std::size_t fin = std::min(inicio + FILAS_POR_BLOQUE, columnas.filas);
+        std::vector<double> puntuaciones(fin - inicio);
+        arbol.evaluateRange(columnas, inicio, fin - inicio, puntuaciones.data());
+
+        MapaCeldas& mapa = parciales[bloque];
+        for (std::size_t fila = inicio; fila < fin; ++fila) {
+            Celda& celda = mapa[clave(fila, puntuaciones[fila - inicio])];
+            if (celda.cantidad++ == 0) {
+                celda.primeraFila = fila;
+            }
+        }
+    });
+
+    std::unordered_map<quint64, std::size_t> indices;   // Clave -> posición de la celda
+    std::vector<std::size_t> primerasFilas;
+    for (const MapaCeldas& mapa : parciales) {
+        for (const auto& par : mapa) {
+            auto it = indices.find(par.first);
+            if (it == indices.end()) {
+                indices.emplace(par.first, cantidades.size());
+                cantidades.push_back(par.second.cantidad);
+                primerasFilas.push_back(par.second.primeraFila);
+            } else {
+                cantidades[it->second] += par.second.cantidad;
+            }
+        }
+    }
+
+    // Ordenar las celdas por su primera fila para que el cubo no dependa del hash
+    std::vector<std::size_t> orden(cantidades.size());
+    for (std::size_t i = 0; i < orden.size(); ++i) {
+        orden[i] = i;
+    }
+    std::sort(orden.begin(), orden.end(), [&](std::size_t a, std::size_t b) {
+        return primerasFilas[a] < primerasFilas[b];
+    });
+
+    std::vector<qint64> cantidadesOrdenadas(orden.size());
+    representantes.redimensionar(orden.size());
+    for (std::size_t celda = 0; celda < orden.size(); ++celda) {
+        const std::size_t fila = primerasFilas[orden[celda]];
+        cantidadesOrdenadas[celda] = cantidades[orden[celda]];
+        representantes.establecerFila(celda, columnas.id[fila], columnas.edad[fila], columnas.sexo[fila],
+                                      columnas.accesoInternet[fila] != 0, columnas.distrito[fila],
+                                      columnas.ubicacion[fila], columnas.ingresos[fila],
+                                      columnas.influenciabilidad[fila], columnas.gasto[fila]);
+        total += cantidadesOrdenadas[celda];
+    }
+    cantidades.swap(cantidadesOrdenadas);
+
+    // La puntuación de la representante vale para toda la celda
+    const ColumnasPoblacion celdas = representantes.obtenerColumnas();
+    puntuaciones.resize(celdas.filas);
+    for (std::size_t celda = 0; celda < celdas.filas; ++celda) {
+        puntuaciones[celda] = arbol.evaluate(celdas, celda);
+    }
+    return true;
+}
@@ -0,0 +1,45 @@
+#ifndef CUBO_POBLACION_H
+#define CUBO_POBLACION_H
+
+#include "../data_estructures/poblacion_columnar.h"
+#include "uplifting_model.h"
+#include <vector>
+
+// Población agrupada en celdas con la misma edad, sexo, acceso a internet,
+// distrito y hoja del árbol de uplift. La hoja es el tramo más grueso de
+// ingresos, influenciabilidad, gasto y ubicación que respeta todos los
+// umbrales del árbol: dos personas en la misma hoja puntúan igual.
+//
+// Todas las personas de una celda cumplen los mismos criterios de inclusión
+// y reciben la misma puntuación de uplift, así que una consulta suma celdas
+// en lugar de recorrer personas. Cada celda guarda su cantidad, su
+// puntuación y una persona representante (la primera que cayó en ella).
+class CuboPoblacion
+{
+public:
+    // Puntuaciones de hoja distintas que caben en la clave empaquetada
+    static constexpr std::size_t MAX_HOJAS = 1 << 16;
+    static constexpr std::size_t FILAS_POR_BLOQUE = 65536;
+
+    // Reemplaza el contenido del cubo. Devuelve false, dejándolo vacío, si el
+    // árbol tiene más puntuaciones distintas de las que caben en la clave.
+    bool construir(const PoblacionColumnar& poblacion, const UpliftModel::CompiledTree& arbol);
+    void limpiar();
+
+    std::size_t numCeldas() const { return cantidades.size(); }
+    qint64 totalPersonas() const { return total; }
+    bool estaVacio() const { return cantidades.empty(); }
+
+    // Una fila por celda, en el orden en que aparecieron
+    ColumnasPoblacion obtenerRepresentantes() const { return representantes.obtenerColumnas(); }
+    qint64 cantidad(std::size_t celda) const { return cantidades[celda]; }
+    double puntuacion(std::size_t celda) const { return puntuaciones[celda]; }
+
+private:
+    PoblacionColumnar representantes;
+    std::vector<qint64> cantidades;
+    std::vector<double> puntuaciones;
+    qint64 total = 0;
+};
+
+#endif // CUBO_POBLACION_H
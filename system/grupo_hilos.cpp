@@ -0,0 +1,125 @@
+#include "grupo_hilos.h"
+#include <algorithm>
+
+GrupoHilos::GrupoHilos(int hilos)
+{
+    if (hilos <= 0) {
+        hilos = hilosDisponibles();
+    }
+
+    // El hilo que llama a ejecutar() también trabaja
+    for (int i = 0; i < hilos - 1; ++i) {
+        trabajadores.emplace_back(&GrupoHilos::bucleTrabajador, this, i);
+    }
+}
+
+GrupoHilos::~GrupoHilos()
+{
+    {
+        std::lock_guard<std::mutex> bloqueo(mutex);
+        detener = true;
+    }
+    hayTrabajo.notify_all();
+
+    for (std::thread& trabajador : trabajadores) {
+        trabajador.join();
+    }
+}
+
+int GrupoHilos::tamano() const
+{
+    const int hilos = static_cast<int>(trabajadores.size()) + 1;
+    const int tope = limite.load();
+    return tope > 0 ? std::min(hilos, tope) : hilos;
+}
+
+void GrupoHilos::limitar(int hilos)
+{
+    limite.store(std::max(0, hilos));
+}
+
+void GrupoHilos::ejecutar(std::size_t numTareas,
+                          const std::function<void(std::size_t)>& tarea,
+                          int maxHilos)
+{
+    if (numTareas == 0) {
+        return;
+    }
+
+    int hilos = (maxHilos <= 0) ? tamano() : std::min(maxHilos, tamano());
+    hilos = static_cast<int>(std::min<std::size_t>(hilos, numTareas));
+
+    // Sin paralelismo útil: ejecutar en el hilo actual
+    if (hilos <= 1) {
+        for (std::size_t i = 0; i < numTareas; ++i) {
+            tarea(i);
+        }
+        return;
+    }
+
+    std::lock_guard<std::mutex> ejecucion(mutexEjecucion);
+
+    {
+        std::lock_guard<std::mutex> bloqueo(mutex);
+        tareaActual = &tarea;
+        totalTareas = numTareas;
+        siguienteTarea.store(0);
+        participantes = hilos - 1;
+        pendientes = participantes;
+        ++generacion;
+    }
+    hayTrabajo.notify_all();
+
+    procesarTareas();
+
+    std::unique_lock<std::mutex> bloqueo(mutex);
+    trabajoTerminado.wait(bloqueo, [this]() { return pendientes == 0; });
+    tareaActual = nullptr;
+}
+
+void GrupoHilos::procesarTareas()
+{
+    std::size_t indice;
+    while ((indice = siguienteTarea.fetch_add(1)) < totalTareas) {
+        (*tareaActual)(indice);
+    }
+}
+
+void GrupoHilos::bucleTrabajador(int indice)
+{
+    unsigned long long generacionVista = 0;
+
+    while (true) {
+        {
+            std::unique_lock<std::mutex> bloqueo(mutex);
+            hayTrabajo.wait(bloqueo, [&]() { return detener || generacion != generacionVista; });
+            if (detener) {
+                return;
+            }
+            generacionVista = generacion;
+            if (indice >= participantes) {
+                continue;
+            }
+        }
+
+        procesarTareas();
+
+        {
+            std::lock_guard<std::mutex> bloqueo(mutex);
+            --pendientes;
+        }
+        trabajoTerminado.notify_one();
+    }
+}
+
+int GrupoHilos::hilosDisponibles()
+{
+    unsigned int hilos = std::thread::hardware_concurrency();
+    return hilos > 0 ? static_cast<int>(hilos) : 1;
+}
+
+GrupoHilos& GrupoHilos::global()
+{
+    static GrupoHilos grupo;
+    return grupo;
+}
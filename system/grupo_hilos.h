@@ -0,0 +1,66 @@
+#ifndef GRUPO_HILOS_H
+#define GRUPO_HILOS_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Grupo de hilos persistente para recorridos por bloques.
+// Los hilos se crean una sola vez y se reutilizan en cada análisis,
+// así un clic en la interfaz no paga la creación de hilos.
+class GrupoHilos
+{
+public:
+    explicit GrupoHilos(int hilos = 0);
+    ~GrupoHilos();
+
+    GrupoHilos(const GrupoHilos&) = delete;
+    GrupoHilos& operator=(const GrupoHilos&) = delete;
+
+    // Hilos disponibles, contando el hilo que llama a ejecutar(), sin pasar
+    // del límite fijado con limitar()
+    int tamano() const;
+
+    // Tope de hilos para todas las llamadas siguientes a ejecutar() (0 = sin
+    // tope). Los trabajadores ya creados sobrantes quedan en espera.
+    void limitar(int hilos);
+
+    // Ejecuta tarea(i) para cada i en [0, numTareas) y espera a que terminen todas.
+    // maxHilos limita cuántos hilos participan (0 = todos). No debe llamarse
+    // desde dentro de una tarea.
+    void ejecutar(std::size_t numTareas,
+                  const std::function<void(std::size_t)>& tarea,
+                  int maxHilos = 0);
+
+    // Número de hilos recomendado para esta máquina
+    static int hilosDisponibles();
+
+    // Grupo compartido por toda la aplicación
+    static GrupoHilos& global();
+
+private:
+    void bucleTrabajador(int indice);
+    void procesarTareas();
+
+    std::vector<std::thread> trabajadores;
+    std::atomic<int> limite{0};
+
+    std::mutex mutexEjecucion;          // Serializa llamadas concurrentes a ejecutar()
+    std::mutex mutex;
+    std::condition_variable hayTrabajo;
+    std::condition_variable trabajoTerminado;
+
+    const std::function<void(std::size_t)>* tareaActual = nullptr;
+    std::size_t totalTareas = 0;
+    std::atomic<std::size_t> siguienteTarea{0};
+    int participantes = 0;              // Trabajadores que toman parte del trabajo actual
+    int pendientes = 0;                 // Trabajadores que aún no terminan
+    unsigned long long generacion = 0;
+    bool detener = false;
+};
+
+#endif // GRUPO_HILOS_H
@@ -4,6 +4,8 @@
 #include <algorithm>
 #include <iomanip>
 #include <cmath>
+#include <stdexcept>
+#include <limits>
 #include <QVector>
 
 namespace UpliftModel {
@@ -34,11 +36,11 @@ double UpliftNode::getFeatureValue(const Persona& persona, const std::string& fe
 
 std::string UpliftNode::getFeatureCategory(const Persona& persona, const std::string& feature) const {
     if (feature == "sexo") {
-        return persona.sexo.toStdString();
+        return persona.nombreSexo().toStdString();
     } else if (feature == "ubicacion") {
-        return persona.ubicacion.toStdString();
+        return persona.nombreUbicacion().toStdString();
     } else if (feature == "distrito") {
-        return persona.distrito.toStdString();
+        return persona.nombreDistrito().toStdString();
     }
     return ""; // Valor por defecto
 }
@@ -55,6 +57,158 @@ double UpliftNode::evaluate(const Persona& persona) const {
     }
 }
 
+// Implementación de CompiledTree
+void CompiledTree::compile(const UpliftNode* root) {
+    nodes_.clear();
+    maskNodes_.clear();
+    leafScores_.clear();
+    append(root);
+    
+    // Las máscaras de hojas caben en 64 bits; árboles más grandes usan el recorrido escalar
+    std::size_t leaves = 0;
+    for (const CompiledNode& node : nodes_) {
+        leaves += node.isLeaf ? 1 : 0;
+    }
+    if (leaves <= 64) {
+        buildMasks(0);
+    }
+    
+    distinctScores_.clear();
+    for (const CompiledNode& node : nodes_) {
+        if (node.isLeaf) {
+            distinctScores_.push_back(node.score);
+        }
+    }
+    if (distinctScores_.empty()) {
+        distinctScores_.push_back(0.0);
+    }
+    std::sort(distinctScores_.begin(), distinctScores_.end());
+    distinctScores_.erase(std::unique(distinctScores_.begin(), distinctScores_.end()), distinctScores_.end());
+}
+
+uint64_t CompiledTree::buildMasks(int32_t index) {
+    const CompiledNode& node = nodes_[index];
+    if (node.isLeaf) {
+        const uint64_t bit = uint64_t(1) << leafScores_.size();
+        leafScores_.push_back(node.score);
+        return bit;
+    }
+    
+    const std::size_t position = maskNodes_.size();
+    maskNodes_.push_back(MaskNode{node.feature, node.lower, node.upper, 0, 0});
+    const uint64_t left = buildMasks(node.left);
+    const uint64_t right = buildMasks(node.right);
+    maskNodes_[position].keepIfFalse = ~right;
+    maskNodes_[position].keepIfTrue = ~left;
+    return left | right;
+}
+
+int32_t CompiledTree::append(const UpliftNode* node) {
+    const double infinity = std::numeric_limits<double>::infinity();
+    const int32_t index = static_cast<int32_t>(nodes_.size());
+    nodes_.push_back(CompiledNode{Feature::Constante, true, -1, -1, 0.0, 0.0, 0.0});
+    
+    // Un hijo ausente se evalúa como 0.0, igual que una hoja con esa puntuación
+    if (!node || node->isLeaf) {
+        nodes_[index].score = node ? node->upliftScore : 0.0;
+        return index;
+    }
+    
+    CompiledNode compiledNode{Feature::Constante, false, -1, -1, 0.0, 0.0, 0.0};
+    const std::string& feature = node->decision.feature;
+    
+    if (node->decision.isNumeric) {
+        // Una característica desconocida vale 0.0, como en getFeatureValue
+        if (feature == "edad") {
+            compiledNode.feature = Feature::Edad;
+        } else if (feature == "ingresos") {
+            compiledNode.feature = Feature::Ingresos;
+        } else if (feature == "influenciabilidad_digital") {
+            compiledNode.feature = Feature::InfluenciabilidadDigital;
+        } else if (feature == "gasto_promedio") {
+            compiledNode.feature = Feature::GastoPromedio;
+        }
+        compiledNode.lower = node->decision.threshold;
+        compiledNode.upper = infinity;
+    } else {
+        const QString category = QString::fromStdString(node->decision.category);
+        double code;
+        if (feature == "sexo") {
+            quint8 codigo = Catalogo::codificarSexo(category);
+            compiledNode.feature = Feature::Sexo;
+            if (codigo == SEXO_MASCULINO || codigo == SEXO_FEMENINO) {
+                code = codigo;
+            } else if (category.isEmpty()) {
+                code = SEXO_DESCONOCIDO;    // nombreSexo() vacío
+            } else {
+                code = -1.0;                // Ninguna persona lo tiene
+            }
+        } else if (feature == "ubicacion" || feature == "distrito") {
+            compiledNode.feature = (feature == "ubicacion") ? Feature::Ubicacion : Feature::Distrito;
+            code = Catalogo::lugares().internar(category);
+        } else {
+            // getFeatureCategory devuelve "" para características desconocidas
+            code = category.isEmpty() ? 0.0 : -1.0;
+        }
+        compiledNode.lower = code;
+        compiledNode.upper = code;
+    }
+    
+    nodes_[index] = compiledNode;
+    const int32_t left = append(node->left.get());
+    const int32_t right = append(node->right.get());
+    nodes_[index].left = left;
+    nodes_[index].right = right;
+    return index;
+}
+
+double CompiledTree::walk(const double* values) const {
+    int32_t i = 0;
+    while (!nodes_[i].isLeaf) {
+        const CompiledNode& node = nodes_[i];
+        const double value = values[static_cast<int>(node.feature)];
+        const bool condition = (value >= node.lower) & (value <= node.upper);
+        i = condition ? node.right : node.left;
+    }
+    return nodes_[i].score;
+}
+
+double CompiledTree::evaluate(const Persona& persona) const {
+    if (nodes_.empty()) {
+        return 0.0;
+    }
+    
+    const double values[static_cast<int>(Feature::Count)] = {
+        static_cast<double>(persona.edad),
+        persona.ingresos,
+        persona.influenciabilidad_digital,
+        persona.gasto_promedio,
+        static_cast<double>(persona.sexo),
+        static_cast<double>(persona.ubicacion),
+        static_cast<double>(persona.distrito),
+        0.0
+    };
+    return walk(values);
+}
+
+double CompiledTree::evaluate(const ColumnasPoblacion& columnas, std::size_t fila) const {
+    if (nodes_.empty()) {
+        return 0.0;
+    }
+    
+    const double values[static_cast<int>(Feature::Count)] = {
+        static_cast<double>(columnas.edad[fila]),
+        columnas.ingresos[fila],
+        columnas.influenciabilidad[fila],
+        columnas.gasto[fila],
+        static_cast<double>(columnas.sexo[fila]),
+        static_cast<double>(columnas.ubicacion[fila]),
+        static_cast<double>(columnas.distrito[fila]),
+        0.0
+    };
+    return walk(values);
+}
+
 // Implementación de UpliftTreeModel
 UpliftTreeModel::UpliftTreeModel() {
     buildPredefinedTree();
@@ -107,9 +261,21 @@ void UpliftTreeModel::buildPredefinedTree() {
     root->right->left = std::make_unique<UpliftNode>(Decision("ingresos", 50000.0));
     root->right->left->right = std::make_unique<UpliftNode>(0.7); // Altos ingresos
     root->right->left->left = std::make_unique<UpliftNode>(0.4);  // Ingresos moderados
+    
+    // Compilar a la forma plana que usan las evaluaciones
+    compiled.compile(root.get());
 }
 
 double UpliftTreeModel::evaluateInfluenciability(const Persona& persona) const {
+    return compiled.evaluate(persona);
+}
+
+double UpliftTreeModel::evaluateInfluenciability(const ColumnasPoblacion& columnas,
+                                                 std::size_t fila) const {
+    return compiled.evaluate(columnas, fila);
+}
+
+double UpliftTreeModel::evaluateRecursive(const Persona& persona) const {
     if (!root) {
         return 0.0;
     }
@@ -232,6 +398,17 @@ std::vector<double> UpliftTreeModel::evaluateBatch(const std::vector<Persona>& p
     return scores;
 }
 
+std::vector<double> UpliftTreeModel::evaluateBatch(const ColumnasPoblacion& columnas) const {
+    return evaluateBatch(columnas, CompiledTree::bestBatchBackend());
+}
+
+std::vector<double> UpliftTreeModel::evaluateBatch(const ColumnasPoblacion& columnas,
+                                                   BatchBackend backend) const {
+    std::vector<double> scores(columnas.filas);
+    compiled.evaluateRange(columnas, 0, columnas.filas, scores.data(), backend);
+    return scores;
+}
+
 // Implementación de las funciones de testing
 namespace Testing {
 
@@ -324,6 +501,10 @@ void runUpliftModelTests() {
     // Comparar resultados
     compareFilterResults(personas, filtered_high);
     
+    // Validar la forma compilada del árbol
+    verifyCompiledTree(model, personas);
+    verifyBatchBackends(model, personas);
+    
     std::cout << "\n=== PRUEBAS COMPLETADAS ===" << std::endl;
 }
 
@@ -384,12 +565,12 @@ void compareFilterResults(const std::vector<Persona>& original,
     int male_filtered = 0, female_filtered = 0;
     
     for (const auto& p : original) {
-        if (p.sexo == "Masculino") male_original++;
+        if (p.sexo == SEXO_MASCULINO) male_original++;
         else female_original++;
     }
     
     for (const auto& p : filtered) {
-        if (p.sexo == "Masculino") male_filtered++;
+        if (p.sexo == SEXO_MASCULINO) male_filtered++;
         else female_filtered++;
     }
     
@@ -413,6 +594,103 @@ void compareFilterResults(const std::vector<Persona>& original,
     }
 }
 
+void verifyCompiledTree(const UpliftTreeModel& model, const std::vector<Persona>& personas) {
+    std::cout << "\n=== VERIFICACIÓN DEL ÁRBOL COMPILADO ===" << std::endl;
+    
+    // Columnas con las mismas personas para validar también ese camino
+    PoblacionColumnar poblacion;
+    poblacion.reservar(personas.size());
+    for (const auto& p : personas) {
+        poblacion.agregar(p);
+    }
+    const ColumnasPoblacion columnas = poblacion.obtenerColumnas();
+    
+    int mismatches = 0;
+    for (std::size_t i = 0; i < personas.size(); ++i) {
+        double expected = model.evaluateRecursive(personas[i]);
+        if (model.evaluateInfluenciability(personas[i]) != expected ||
+            model.evaluateInfluenciability(columnas, i) != expected) {
+            mismatches++;
+        }
+    }
+    
+    std::cout << "Nodos compilados: " << model.compiledTree().nodes().size() << std::endl;
+    if (mismatches == 0) {
+        std::cout << "✓ El árbol compilado coincide con la evaluación recursiva en "
+                  << personas.size() << " personas" << std::endl;
+    } else {
+        std::cout << "✗ " << mismatches << " personas con puntuación distinta" << std::endl;
+        throw std::runtime_error("El árbol compilado no coincide con la evaluación recursiva");
+    }
+}
+
+void verifyBatchBackends(const UpliftTreeModel& model, const std::vector<Persona>& personas) {
+    std::cout << "\n=== VERIFICACIÓN DE LA EVALUACIÓN POR LOTES ===" << std::endl;
+    
+    // Añadir personas justo en cada umbral numérico y justo por debajo,
+    // donde una comparación mal vectorizada cambiaría de rama
+    std::vector<Persona> casos = personas;
+    for (const CompiledNode& node : model.compiledTree().nodes()) {
+        if (node.isLeaf || personas.empty()) {
+            continue;
+        }
+        const double valores[] = { node.lower, std::nextafter(node.lower, -1e300) };
+        for (double valor : valores) {
+            Persona p = personas[casos.size() % personas.size()];
+            switch (node.feature) {
+            case Feature::Edad:
+                p.edad = std::clamp(static_cast<int>(std::ceil(valor)), 0, PoblacionColumnar::EDAD_MAXIMA);
+                break;
+            case Feature::Ingresos: p.ingresos = valor; break;
+            case Feature::InfluenciabilidadDigital: p.influenciabilidad_digital = valor; break;
+            case Feature::GastoPromedio: p.gasto_promedio = valor; break;
+            default: break;
+            }
+            casos.push_back(p);
+        }
+    }
+    
+    // Un tamaño que no es múltiplo de 8 ejercita también la cola escalar
+    if (casos.size() % 8 == 0) {
+        casos.pop_back();
+    }
+    
+    PoblacionColumnar poblacion;
+    poblacion.reservar(casos.size());
+    for (const auto& p : casos) {
+        poblacion.agregar(p);
+    }
+    const ColumnasPoblacion columnas = poblacion.obtenerColumnas();
+    
+    const BatchBackend best = CompiledTree::bestBatchBackend();
+    std::cout << "Mejor backend disponible: " << CompiledTree::backendName(best) << std::endl;
+    
+    for (BatchBackend backend : { BatchBackend::Scalar, BatchBackend::AVX2, BatchBackend::AVX512 }) {
+        if (static_cast<int>(backend) > static_cast<int>(best)) {
+            std::cout << "- " << CompiledTree::backendName(backend) << ": no soportado, omitido" << std::endl;
+            continue;
+        }
+        
+        std::vector<double> scores = model.evaluateBatch(columnas, backend);
+        int mismatches = 0;
+        for (std::size_t i = 0; i < casos.size(); ++i) {
+            // Referencia: el árbol de nodos enlazados sobre la persona tal como quedó en columnas
+            if (scores[i] != model.evaluateRecursive(poblacion.obtenerPersona(i))) {
+                mismatches++;
+            }
+        }
+        
+        if (mismatches == 0) {
+            std::cout << "✓ " << CompiledTree::backendName(backend) << " coincide en "
+                      << casos.size() << " personas" << std::endl;
+        } else {
+            std::cout << "✗ " << CompiledTree::backendName(backend) << ": "
+                      << mismatches << " personas con puntuación distinta" << std::endl;
+            throw std::runtime_error("La evaluación por lotes no coincide con la evaluación recursiva");
+        }
+    }
+}
+
 } // namespace Testing
 
 } // namespace UpliftModel
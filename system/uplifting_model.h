@@ -6,6 +6,7 @@
 #include <map>
 #include <string>
 #include "../data_estructures/persona.h"
+#include "../data_estructures/poblacion_columnar.h"
 
 namespace UpliftModel {
 
@@ -54,10 +55,100 @@ private:
     std::string getFeatureCategory(const Persona& persona, const std::string& feature) const;
 };
 
+// Característica evaluada por un nodo compilado
+enum class Feature : uint8_t {
+    Edad,
+    Ingresos,
+    InfluenciabilidadDigital,
+    GastoPromedio,
+    Sexo,
+    Ubicacion,
+    Distrito,
+    Constante,  // Característica desconocida: siempre vale 0.0
+    Count
+};
+
+// Nodo del árbol compilado. Toda condición se reduce a un intervalo:
+// se cumple si lower <= valor <= upper. Las numéricas usan [umbral, +inf)
+// y las categóricas [código, código]. Los hijos son índices del arreglo.
+struct CompiledNode {
+    Feature feature;
+    bool isLeaf;
+    int32_t left;         // No cumple condición
+    int32_t right;        // Cumple condición
+    double lower;
+    double upper;
+    double score;
+};
+
+// Implementación usada para evaluar lotes de filas
+enum class BatchBackend : uint8_t {
+    Scalar,   // Recorrido fila a fila del árbol compilado
+    AVX2,     // 4 filas por instrucción
+    AVX512    // 8 filas por instrucción
+};
+
+// Forma compilada del árbol: arreglo plano de nodos con características
+// enumeradas, umbrales numéricos y categorías ya internadas. Se evalúa de
+// forma iterativa, sin reservar memoria y sin saltos dependientes de la
+// característica: cada fila carga sus valores una vez y cada nivel es una
+// comparación con selección del hijo.
+class CompiledTree {
+public:
+    // Traduce el árbol de nodos enlazados; un hijo ausente se vuelve una hoja 0.0
+    void compile(const UpliftNode* root);
+    
+    double evaluate(const Persona& persona) const;
+    double evaluate(const ColumnasPoblacion& columnas, std::size_t fila) const;
+    
+    // Evalúa las filas [inicio, inicio + cantidad) y escribe sus puntuaciones
+    // en salida. Sin backend explícito usa el mejor que soporte el procesador.
+    void evaluateRange(const ColumnasPoblacion& columnas, std::size_t inicio,
+                       std::size_t cantidad, double* salida) const;
+    void evaluateRange(const ColumnasPoblacion& columnas, std::size_t inicio,
+                       std::size_t cantidad, double* salida, BatchBackend backend) const;
+    
+    // Mejor backend disponible en este procesador (se detecta una vez)
+    static BatchBackend bestBatchBackend();
+    static const char* backendName(BatchBackend backend);
+    
+    const std::vector<CompiledNode>& nodes() const { return nodes_; }
+    bool empty() const { return nodes_.empty(); }
+    
+    // Puntuaciones distintas de las hojas, ordenadas; un árbol vacío tiene
+    // solo 0.0. Agrupar las filas por su posición aquí equivale a agruparlas por hoja
+    const std::vector<double>& distinctLeafScores() const { return distinctScores_; }
+    
+    // Nodo interno en forma de máscaras de hojas (estilo QuickScorer):
+    // cada condición descarta con un AND las hojas del lado no tomado,
+    // y la única hoja que sobrevive es la que alcanzaría el recorrido.
+    struct MaskNode {
+        Feature feature;
+        double lower;
+        double upper;
+        uint64_t keepIfFalse;   // Borra las hojas del subárbol derecho
+        uint64_t keepIfTrue;    // Borra las hojas del subárbol izquierdo
+    };
+    
+private:
+    std::vector<CompiledNode> nodes_;
+    
+    // Tablas para la evaluación vectorizada; vacías si hay más de 64 hojas
+    std::vector<MaskNode> maskNodes_;
+    std::vector<double> leafScores_;
+    
+    std::vector<double> distinctScores_{0.0};
+    
+    int32_t append(const UpliftNode* node);
+    uint64_t buildMasks(int32_t index);
+    double walk(const double* values) const;
+};
+
 // Clase principal del modelo de uplift
 class UpliftTreeModel {
 private:
     std::unique_ptr<UpliftNode> root;
+    CompiledTree compiled;
     
 public:
     UpliftTreeModel();
@@ -68,6 +159,13 @@ public:
     
     // Evalúa una persona y devuelve su puntuación de influenciabilidad
     double evaluateInfluenciability(const Persona& persona) const;
+    double evaluateInfluenciability(const ColumnasPoblacion& columnas, std::size_t fila) const;
+    
+    // Evaluación recursiva sobre los nodos enlazados (referencia para pruebas)
+    double evaluateRecursive(const Persona& persona) const;
+    
+    // Árbol compilado que usan las evaluaciones anteriores
+    const CompiledTree& compiledTree() const { return compiled; }
     
     // Filtra una lista de personas basándose en el umbral de influenciabilidad
     std::vector<Persona> filterByInfluenciability(
@@ -80,6 +178,8 @@ public:
     // Métodos para testing y debugging
     void printTreeStructure() const;
     std::vector<double> evaluateBatch(const std::vector<Persona>& personas) const;
+    std::vector<double> evaluateBatch(const ColumnasPoblacion& columnas) const;
+    std::vector<double> evaluateBatch(const ColumnasPoblacion& columnas, BatchBackend backend) const;
 };
 
 // Funciones auxiliares para testing
@@ -96,6 +196,12 @@ namespace Testing {
     // Compara resultados antes y después del filtro de uplift
     void compareFilterResults(const std::vector<Persona>& original, 
                              const std::vector<Persona>& filtered);
+    
+    // Verifica que el árbol compilado coincide con la evaluación recursiva
+    void verifyCompiledTree(const UpliftTreeModel& model, const std::vector<Persona>& personas);
+    
+    // Verifica que cada backend de evaluación por lotes coincide con UpliftNode::evaluate
+    void verifyBatchBackends(const UpliftTreeModel& model, const std::vector<Persona>& personas);
 }
 
 } // namespace UpliftModel
@@ -0,0 +1,103 @@
+#include "grafico_alcance.h"
+#include <QPainter>
+#include <QPainterPath>
+#include <algorithm>
+
+GraficoAlcance::GraficoAlcance(QWidget *parent)
+    : QWidget(parent)
+    , umbralMarcado(-1.0)
+{
+    setMinimumHeight(180);
+}
+
+void GraficoAlcance::establecerCurva(const QVector<PuntoAlcance>& puntos)
+{
+    curva = puntos;
+    update();
+}
+
+void GraficoAlcance::establecerUmbralMarcado(double umbral)
+{
+    umbralMarcado = umbral;
+    update();
+}
+
+void GraficoAlcance::paintEvent(QPaintEvent *)
+{
+    QPainter painter(this);
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.fillRect(rect(), QColor(248, 249, 250));
+
+    if (curva.size() < 2) {
+        painter.setPen(QColor(108, 117, 125));
+        painter.drawText(rect(), Qt::AlignCenter, "Sin datos para la curva de alcance");
+        return;
+    }
+
+    // Área de trazado con márgenes para los ejes
+    const QRectF area = QRectF(rect()).adjusted(60, 15, -15, -35);
+    const double umbralMin = curva.first().umbral;
+    const double umbralMax = curva.last().umbral;
+    double valorMax = 1.0;
+    for (const PuntoAlcance& p : curva) {
+        valorMax = std::max({valorMax, p.estimacion.limiteSuperior,
+                             static_cast<double>(p.traficoConUplift)});
+    }
+
+    auto x = [&](double umbral) {
+        const double ancho = umbralMax > umbralMin ? umbralMax - umbralMin : 1.0;
+        return area.left() + (umbral - umbralMin) / ancho * area.width();
+    };
+    auto y = [&](double valor) {
+        return area.bottom() - valor / valorMax * area.height();
+    };
+
+    // Ejes y marcas
+    painter.setPen(QColor(189, 195, 199));
+    painter.drawLine(area.bottomLeft(), area.bottomRight());
+    painter.drawLine(area.bottomLeft(), area.topLeft());
+    painter.setPen(QColor(44, 62, 80));
+    QFont fuente = painter.font();
+    fuente.setPointSize(8);
+    painter.setFont(fuente);
+    for (const PuntoAlcance& p : curva) {
+        QRectF etiqueta(x(p.umbral) - 20, area.bottom() + 4, 40, 14);
+        painter.drawText(etiqueta, Qt::AlignCenter, QString::number(p.umbral, 'f', 2));
+    }
+    for (int i = 0; i <= 4; ++i) {
+        const double valor = valorMax * i / 4.0;
+        QRectF etiqueta(0, y(valor) - 7, area.left() - 6, 14);
+        painter.drawText(etiqueta, Qt::AlignRight | Qt::AlignVCenter, QString::number(qRound64(valor)));
+    }
+    painter.drawText(QRectF(area.left(), area.bottom() + 18, area.width(), 14), Qt::AlignCenter,
+                     "Umbral de influenciabilidad");
+
+    // Banda del intervalo de confianza
+    QPainterPath banda;
+    banda.moveTo(x(curva.first().umbral), y(curva.first().estimacion.limiteSuperior));
+    for (const PuntoAlcance& p : curva) {
+        banda.lineTo(x(p.umbral), y(p.estimacion.limiteSuperior));
+    }
+    for (int i = curva.size() - 1; i >= 0; --i) {
+        banda.lineTo(x(curva[i].umbral), y(curva[i].estimacion.limiteInferior));
+    }
+    banda.closeSubpath();
+    painter.fillPath(banda, QColor(52, 152, 219, 60));
+
+    // Valor esperado y conversiones sorteadas
+    QPainterPath linea;
+    linea.moveTo(x(curva.first().umbral), y(curva.first().estimacion.esperado));
+    for (const PuntoAlcance& p : curva) {
+        linea.lineTo(x(p.umbral), y(p.estimacion.esperado));
+    }
+    painter.setPen(QPen(QColor(52, 152, 219), 2));
+    painter.drawPath(linea);
+
+    painter.setPen(Qt::NoPen);
+    for (const PuntoAlcance& p : curva) {
+        const bool marcado = qFuzzyCompare(1.0 + p.umbral, 1.0 + umbralMarcado);
+        painter.setBrush(marcado ? QColor(231, 76, 60) : QColor(44, 62, 80));
+        const double radio = marcado ? 5.0 : 3.5;
+        painter.drawEllipse(QPointF(x(p.umbral), y(p.traficoConUplift)), radio, radio);
+    }
+}
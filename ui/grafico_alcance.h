@@ -0,0 +1,34 @@
+#ifndef GRAFICO_ALCANCE_H
+#define GRAFICO_ALCANCE_H
+
+#include <QWidget>
+#include <QVector>
+#include "../data_estructures/persona.h"
+
+// Gráfico de la curva de alcance: clientes esperados por umbral de uplift
+// con su intervalo de confianza y las conversiones sorteadas. Se dibuja con
+// QPainter para no depender de Qt Charts.
+class GraficoAlcance : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit GraficoAlcance(QWidget *parent = nullptr);
+
+    // Puntos en orden creciente de umbral
+    void establecerCurva(const QVector<PuntoAlcance>& puntos);
+
+    // Umbral que se resalta (el del resultado principal)
+    void establecerUmbralMarcado(double umbral);
+
+    QSize sizeHint() const override { return QSize(560, 220); }
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+
+private:
+    QVector<PuntoAlcance> curva;
+    double umbralMarcado;
+};
+
+#endif // GRAFICO_ALCANCE_H
@@ -2,16 +2,29 @@
 #include "./ui_mainwindow.h"
 #include <QApplication>
 #include <QStandardPaths>
+#include <QFileInfo>
 #include <QSplashScreen>
 #include <QPixmap>
 #include <QTimer>
 #include <QScreen>
 #include <QPainter>
+#include <QtConcurrent>
+#include <algorithm>
 #include <iostream>
 
+const double MainWindow::UMBRAL_POR_DEFECTO = 0.5;
+const int MainWindow::PAUSA_EN_VIVO_MS = 300;
+
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
     , ui(new Ui::MainWindow)
+    , splash(nullptr)
+    , vigilanteCarga(new QFutureWatcher<void>(this))
+    , vigilanteAnalisis(new QFutureWatcher<ResultadoCurva>(this))
+    , temporizadorEnVivo(new QTimer(this))
+    , vigilanteEnVivo(new QFutureWatcher<ResultadoCurva>(this))
+    , recalculoPendiente(false)
+    , poblacionLista(false)
     , gestorDatos(new GestorDatos())
     , analizadorTrafico(new AnalizadorTrafico())
 {
@@ -29,12 +42,25 @@ MainWindow::MainWindow(QWidget *parent)
     setupUI();
     setupStyleSheet();
     
-    // Inicializar datos
+    // Inicializar datos (en segundo plano; la ventana queda usable de inmediato)
     inicializarDatos();
 }
 
 MainWindow::~MainWindow()
 {
+    // La carga y el análisis en curso usan el gestor, el analizador y la
+    // población: cancelarlos y esperar a que terminen
+    cargaCancelada.store(true);
+    if (controlAnalisis) {
+        controlAnalisis->cancelar();
+    }
+    if (controlEnVivo) {
+        controlEnVivo->cancelar();
+    }
+    vigilanteAnalisis->waitForFinished();
+    vigilanteEnVivo->waitForFinished();
+    vigilanteCarga->waitForFinished();
+    
     delete ui;
     delete gestorDatos;
     delete analizadorTrafico;
@@ -131,15 +157,56 @@ void MainWindow::setupUI()
     btnIniciarAnalisis->setObjectName("btnAnalisis");
     btnIniciarAnalisis->setMinimumHeight(50);
     
+    // Progreso y cancelación del análisis (ocultos hasta que se inicia uno)
+    barraProgreso = new QProgressBar();
+    barraProgreso->setRange(0, 100);
+    barraProgreso->setVisible(false);
+    
+    btnCancelarAnalisis = new QPushButton("Cancelar");
+    btnCancelarAnalisis->setVisible(false);
+    
+    QHBoxLayout *layoutProgreso = new QHBoxLayout();
+    layoutProgreso->addWidget(barraProgreso, 1);
+    layoutProgreso->addWidget(btnCancelarAnalisis);
+    
+    // Modo en vivo (opcional): resultado en la ventana mientras se edita
+    checkEnVivo = new QCheckBox("Resultados en vivo al editar");
+    labelEnVivo = new QLabel();
+    labelEnVivo->setObjectName("labelEnVivo");
+    labelEnVivo->setAlignment(Qt::AlignCenter);
+    labelEnVivo->setVisible(false);
+    graficoEnVivo = new GraficoAlcance();
+    graficoEnVivo->establecerUmbralMarcado(UMBRAL_POR_DEFECTO);
+    graficoEnVivo->setVisible(false);
+    temporizadorEnVivo->setSingleShot(true);
+    temporizadorEnVivo->setInterval(PAUSA_EN_VIVO_MS);
+    
     // Conectar señales
     connect(comboTipoEspacio, QOverload<int>::of(&QComboBox::currentIndexChanged), 
             this, &MainWindow::onTipoEspacioChanged);
     connect(btnIniciarAnalisis, &QPushButton::clicked, this, &MainWindow::iniciarAnalisis);
+    connect(btnCancelarAnalisis, &QPushButton::clicked, this, &MainWindow::cancelarAnalisis);
+    connect(vigilanteAnalisis, &QFutureWatcher<ResultadoCurva>::finished,
+            this, &MainWindow::onAnalisisTerminado);
+    connect(vigilanteCarga, &QFutureWatcher<void>::finished, this, &MainWindow::onCargaTerminada);
     connect(spinEdadMin, QOverload<int>::of(&QSpinBox::valueChanged), 
             this, &MainWindow::onEdadMinChanged);
     connect(spinEdadMax, QOverload<int>::of(&QSpinBox::valueChanged), 
             this, &MainWindow::onEdadMaxChanged);
     
+    // Cualquier edición relanza el análisis en vivo (tras la pausa)
+    connect(checkEnVivo, &QCheckBox::toggled, this, &MainWindow::onModoEnVivoCambiado);
+    connect(temporizadorEnVivo, &QTimer::timeout, this, &MainWindow::recalcularEnVivo);
+    connect(vigilanteEnVivo, &QFutureWatcher<ResultadoCurva>::finished,
+            this, &MainWindow::onEnVivoTerminado);
+    connect(spinEdadMin, QOverload<int>::of(&QSpinBox::valueChanged), this, &MainWindow::onEntradaCambiada);
+    connect(spinEdadMax, QOverload<int>::of(&QSpinBox::valueChanged), this, &MainWindow::onEntradaCambiada);
+    connect(comboSexo, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &MainWindow::onEntradaCambiada);
+    connect(checkAccesoInternet, &QCheckBox::toggled, this, &MainWindow::onEntradaCambiada);
+    connect(comboProducto, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &MainWindow::onEntradaCambiada);
+    connect(comboTipoEspacio, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &MainWindow::onEntradaCambiada);
+    connect(comboEspacio, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &MainWindow::onEntradaCambiada);
+    
     // Inicializar espacios y estado del checkbox
     actualizarEspacios();
     actualizarRequiereInternet();
@@ -150,6 +217,10 @@ void MainWindow::setupUI()
     layoutPrincipal->addWidget(grupoRegion);
     layoutPrincipal->addWidget(labelInfo);
     layoutPrincipal->addWidget(btnIniciarAnalisis);
+    layoutPrincipal->addLayout(layoutProgreso);
+    layoutPrincipal->addWidget(checkEnVivo);
+    layoutPrincipal->addWidget(labelEnVivo);
+    layoutPrincipal->addWidget(graficoEnVivo);
     layoutPrincipal->addStretch();
 }
 
@@ -245,6 +316,16 @@ void MainWindow::setupStyleSheet()
             background-color: #21618c;
         }
         
+        #labelEnVivo {
+            font-size: 16px;
+            font-weight: bold;
+            color: #e74c3c;
+            padding: 10px;
+            background-color: white;
+            border: 2px solid #e74c3c;
+            border-radius: 8px;
+        }
+        
         #labelInfo {
             font-size: 12px;
             color: #7f8c8d;
@@ -284,21 +365,83 @@ void MainWindow::setupStyleSheet()
 void MainWindow::inicializarDatos()
 {
     QString rutaCSV = obtenerRutaCSV();
+    QString rutaInstantanea = obtenerRutaInstantanea();
     
-    // Intentar cargar datos existentes
-    gestorDatos->cargarPoblacionDesdeCSV(rutaCSV);
-
+    // La instantánea solo vale si no es más antigua que el CSV
+    QFileInfo infoCSV(rutaCSV);
+    QFileInfo infoInstantanea(rutaInstantanea);
+    bool instantaneaVigente = infoInstantanea.exists() &&
+        (!infoCSV.exists() || infoInstantanea.lastModified() >= infoCSV.lastModified());
     
-    // Si no hay datos, generar población
-    if (gestorDatos->obtenerPoblacion().isEmpty()) {
-        gestorDatos->generarPoblacion(50000);
-        gestorDatos->guardarPoblacionEnCSV(rutaCSV);
+    // El análisis queda deshabilitado hasta que la población esté lista
+    btnIniciarAnalisis->setEnabled(false);
+    btnIniciarAnalisis->setText("Cargando población...");
+    barraProgreso->setValue(0);
+    barraProgreso->setVisible(true);
+    
+    // El avance llega desde el hilo de carga; se reenvía al hilo de la interfaz
+    auto avisar = [this](const QString& etapa) {
+        return [this, etapa](int porcentaje) {
+            QMetaObject::invokeMethod(this, [this, etapa, porcentaje]() {
+                actualizarProgresoCarga(etapa, porcentaje);
+            }, Qt::QueuedConnection);
+        };
+    };
+    
+    GestorDatos *gestor = gestorDatos;
+    const std::atomic<bool> *cancelado = &cargaCancelada;
+    vigilanteCarga->setFuture(QtConcurrent::run([=]() {
+        // La instantánea se abre mapeada, sin leer el archivo
+        if (instantaneaVigente && gestor->cargarInstantanea(rutaInstantanea)) {
+            return;
+        }
+        
+        // Intentar cargar datos existentes
+        gestor->cargarPoblacionDesdeCSV(rutaCSV, avisar("Cargando población"), cancelado);
+        
+        // Si no hay datos, generar población
+        if (gestor->obtenerPoblacion().estaVacia() && !cancelado->load()) {
+            gestor->generarPoblacion(50000, GeneradorPoblacion::SEMILLA_POR_DEFECTO,
+                                     avisar("Generando población"), cancelado);
+            if (!cancelado->load()) {
+                gestor->guardarPoblacionEnCSV(rutaCSV, avisar("Guardando población"), cancelado);
+            }
+        }
+        // Una carga cancelada no debe reemplazar la instantánea vigente
+        if (!cancelado->load()) {
+            gestor->guardarInstantanea(rutaInstantanea);
+        }
+    }));
+}
+
+void MainWindow::actualizarProgresoCarga(const QString& etapa, int porcentaje)
+{
+    barraProgreso->setValue(porcentaje);
+    if (splash) {
+        splash->showMessage(QString("%1... %2%").arg(etapa).arg(porcentaje),
+                            Qt::AlignBottom | Qt::AlignHCenter, Qt::white);
     }
 }
 
+void MainWindow::onCargaTerminada()
+{
+    // Los conteos guardados son de la población anterior
+    cacheConteos.limpiar();
+    poblacionLista = true;
+    
+    if (splash) {
+        splash->close();
+        splash->deleteLater();
+        splash = nullptr;
+    }
+    
+    restaurarEstadoAnalisis();
+    onEntradaCambiada();
+}
+
 void MainWindow::mostrarSplashScreen()
 {
-    QSplashScreen *splash = new QSplashScreen();
+    splash = new QSplashScreen();
     splash->setFixedSize(400, 300);
     
     // Crear un pixmap simple para el splash
@@ -310,11 +453,9 @@ void MainWindow::mostrarSplashScreen()
     painter.setFont(QFont("Arial", 18, QFont::Bold));
     painter.drawText(pixmap.rect(), Qt::AlignCenter, "Publicidad Efectiva\n\nCargando...");
     
+    // Se cierra cuando termina la carga de datos (o con un clic)
     splash->setPixmap(pixmap);
     splash->show();
-    
-    QTimer::singleShot(2000, splash, &QSplashScreen::close);
-    QTimer::singleShot(2000, splash, &QSplashScreen::deleteLater);
 }
 
 void MainWindow::onTipoEspacioChanged()
@@ -380,19 +521,185 @@ void MainWindow::iniciarAnalisis()
     // Deshabilitar botón durante análisis
     btnIniciarAnalisis->setEnabled(false);
     btnIniciarAnalisis->setText("Analizando...");
+    barraProgreso->setValue(0);
+    barraProgreso->setVisible(true);
+    btnCancelarAnalisis->setEnabled(true);
+    btnCancelarAnalisis->setVisible(true);
+    
+    // El progreso llega desde los hilos del análisis; se reenvía al hilo de la interfaz
+    auto control = std::make_shared<ControlAnalisis>();
+    QProgressBar *barra = barraProgreso;
+    control->progreso = [barra](std::size_t hechos, std::size_t total) {
+        int porcentaje = static_cast<int>(hechos * 100 / total);
+        QMetaObject::invokeMethod(barra, [barra, porcentaje]() {
+            barra->setValue(std::max(barra->value(), porcentaje));
+        }, Qt::QueuedConnection);
+    };
+    controlAnalisis = control;
+    analisisEnCurso = ResultadoAnalisis(0, espacio, producto, tipoEspacio, cliente);
+    
+    // Realizar análisis en segundo plano
+    vigilanteAnalisis->setFuture(lanzarAnalisis(cliente, espacio, producto, tipoEspacio, control));
+}
+
+// Con los conteos ya en caché no se recorre la población
+QFuture<ResultadoCurva> MainWindow::lanzarAnalisis(const ClienteIdeal& cliente,
+                                                   const QString& espacio,
+                                                   const QString& producto,
+                                                   const QString& tipoEspacio,
+                                                   std::shared_ptr<ControlAnalisis> control)
+{
+    AnalizadorTrafico *analizador = analizadorTrafico;
+    const IndiceDistritos *indice = &gestorDatos->obtenerIndiceDistritos();
+    const IndiceBitmap *bitmap = &gestorDatos->obtenerIndiceBitmap();
+    CacheConteos *cache = &cacheConteos;
+    const QVector<double> umbrales = umbralesCurva();
+    const QString clave = CacheConteos::clave(cliente, espacio, producto, tipoEspacio,
+                                              analizador->obtenerSemilla());
+    return QtConcurrent::run([=]() {
+        ResultadoCurva resultado;
+        resultado.personasConPerfil = analizador->calcularTrafico(*bitmap, cliente, espacio,
+                                                                  producto, tipoEspacio);
+        std::shared_ptr<const ConteosPorEdad> conteos = cache->buscar(clave);
+        if (!conteos) {
+            auto nuevos = std::make_shared<ConteosPorEdad>();
+            if (!analizador->calcularConteosPorEdad(*indice, cliente, espacio, producto,
+                                                    tipoEspacio, *nuevos, control.get())) {
+                return resultado;
+            }
+            cache->guardar(clave, nuevos);
+            conteos = nuevos;
+        }
+        resultado.curva = analizador->calcularCurvaAlcance(*conteos, cliente, umbrales);
+        resultado.completo = true;
+        return resultado;
+    });
+}
+
+void MainWindow::cancelarAnalisis()
+{
+    if (controlAnalisis) {
+        controlAnalisis->cancelar();
+        btnCancelarAnalisis->setEnabled(false);
+        btnIniciarAnalisis->setText("Cancelando...");
+    }
+}
+
+void MainWindow::onAnalisisTerminado()
+{
+    controlAnalisis.reset();
+    restaurarEstadoAnalisis();
+    
+    // Crear resultado con el punto del umbral por defecto; un análisis
+    // cancelado solo trae el conteo de personas con el perfil
+    const ResultadoCurva analisis = vigilanteAnalisis->result();
+    ResultadoAnalisis resultado = analisisEnCurso;
+    if (const PuntoAlcance* punto = puntoPorDefecto(analisis.curva)) {
+        resultado.clientesPotenciales = punto->traficoConUplift;
+    }
+    
+    // Mostrar resultados
+    mostrarResultados(resultado, analisis);
+}
+
+const PuntoAlcance* MainWindow::puntoPorDefecto(const QVector<PuntoAlcance>& curva)
+{
+    for (const PuntoAlcance& punto : curva) {
+        if (punto.umbral == UMBRAL_POR_DEFECTO) {
+            return &punto;
+        }
+    }
+    return nullptr;
+}
+
+void MainWindow::onModoEnVivoCambiado(bool activo)
+{
+    labelEnVivo->setVisible(activo);
+    graficoEnVivo->setVisible(activo);
+    if (activo) {
+        labelEnVivo->setText("Calculando...");
+        onEntradaCambiada();
+    } else {
+        temporizadorEnVivo->stop();
+        recalculoPendiente = false;
+        if (controlEnVivo) {
+            controlEnVivo->cancelar();
+        }
+    }
+}
+
+void MainWindow::onEntradaCambiada()
+{
+    // Cada edición reinicia la pausa: solo se calcula cuando el usuario se detiene
+    if (checkEnVivo->isChecked() && poblacionLista) {
+        temporizadorEnVivo->start();
+    }
+}
+
+void MainWindow::recalcularEnVivo()
+{
+    if (comboEspacio->currentText().isEmpty()) {
+        return;
+    }
     
-    // Realizar análisis
-    QApplication::processEvents(); // Actualizar UI
+    // El cálculo en curso ya no corresponde al formulario: cancelarlo y
+    // relanzar cuando termine
+    if (vigilanteEnVivo->isRunning()) {
+        if (controlEnVivo) {
+            controlEnVivo->cancelar();
+        }
+        recalculoPendiente = true;
+        return;
+    }
     
-    int clientesPotenciales = analizadorTrafico->calcularTraficoConUplift(
-        gestorDatos->obtenerPoblacion(), cliente, espacio, producto, tipoEspacio
-    );
+    controlEnVivo = std::make_shared<ControlAnalisis>();
+    labelEnVivo->setText("Calculando...");
+    vigilanteEnVivo->setFuture(lanzarAnalisis(obtenerClienteIdeal(), comboEspacio->currentText(),
+                                              comboProducto->currentText(),
+                                              comboTipoEspacio->currentText(), controlEnVivo));
+}
+
+void MainWindow::onEnVivoTerminado()
+{
+    bool cancelado = controlEnVivo && controlEnVivo->estaCancelado();
+    controlEnVivo.reset();
     
-    // Crear resultado
-    ResultadoAnalisis resultado(clientesPotenciales, espacio, producto, tipoEspacio, cliente);
+    if (recalculoPendiente) {
+        recalculoPendiente = false;
+        recalcularEnVivo();
+        return;
+    }
+    const ResultadoCurva analisis = vigilanteEnVivo->result();
+    if (cancelado || !analisis.completo || !checkEnVivo->isChecked()) {
+        return;
+    }
     
-    // Mostrar resultados
-    mostrarResultados(resultado);
+    graficoEnVivo->establecerCurva(analisis.curva);
+    if (const PuntoAlcance* punto = puntoPorDefecto(analisis.curva)) {
+        labelEnVivo->setText(QString("🎯 Clientes Potenciales: %1 de %2 con el perfil  "
+                                     "(esperado %3, intervalo %4 – %5)")
+                             .arg(punto->traficoConUplift)
+                             .arg(analisis.personasConPerfil)
+                             .arg(qRound64(punto->estimacion.esperado))
+                             .arg(qRound64(punto->estimacion.limiteInferior))
+                             .arg(qRound64(punto->estimacion.limiteSuperior)));
+    }
+}
+
+QVector<double> MainWindow::umbralesCurva()
+{
+    // 0.3, 0.4, ..., 0.9; incluye UMBRAL_POR_DEFECTO
+    QVector<double> umbrales;
+    for (int i = 3; i <= 9; ++i) {
+        umbrales.append(i / 10.0);
+    }
+    return umbrales;
+}
+
+void MainWindow::restaurarEstadoAnalisis()
+{
+    barraProgreso->setVisible(false);
+    btnCancelarAnalisis->setVisible(false);
     
     // Rehabilitar botón
     btnIniciarAnalisis->setEnabled(true);
@@ -424,11 +731,11 @@ ClienteIdeal MainWindow::obtenerClienteIdeal()
     );
 }
 
-void MainWindow::mostrarResultados(const ResultadoAnalisis& resultado)
+void MainWindow::mostrarResultados(const ResultadoAnalisis& resultado, const ResultadoCurva& analisis)
 {
     QDialog *dialogo = new QDialog(this);
     dialogo->setWindowTitle("Resultados del Análisis");
-    dialogo->setFixedSize(600, 450);
+    dialogo->setFixedSize(600, 700);
     dialogo->setModal(true);
     
     // Centrar diálogo
@@ -447,8 +754,10 @@ void MainWindow::mostrarResultados(const ResultadoAnalisis& resultado)
     layout->addWidget(titulo);
     
     // Resultado principal
-    QLabel *resultadoPrincipal = new QLabel(QString("🎯 Clientes Potenciales: %1")
-                                           .arg(resultado.clientesPotenciales));
+    QLabel *resultadoPrincipal = new QLabel(analisis.completo
+                                           ? QString("🎯 Clientes Potenciales: %1")
+                                                 .arg(resultado.clientesPotenciales)
+                                           : QString("⏹️ Análisis cancelado"));
     resultadoPrincipal->setStyleSheet("font-size: 28px; font-weight: bold; color: #e74c3c; "
                                      "background-color: #f8f9fa; padding: 20px; border-radius: 10px; "
                                      "border: 3px solid #e74c3c;");
@@ -465,21 +774,44 @@ void MainWindow::mostrarResultados(const ResultadoAnalisis& resultado)
         "🛍️ <b>Producto/Servicio:</b> %3<br>"
         "👥 <b>Cliente Ideal:</b> %4 - %5 años, %6<br>"
         "🌐 <b>Requiere Internet:</b> %7<br><br>"
-        "📈 <b>Población Total Analizada:</b> %8 personas"
+        "📈 <b>Población Total Analizada:</b> %8 personas<br>"
+        "👥 <b>Personas con el perfil:</b> %9<br>"
+        "🎲 <b>Semilla de los sorteos:</b> %10"
     ).arg(resultado.espacio)
      .arg(resultado.tipoEspacio)
      .arg(resultado.producto)
      .arg(resultado.clienteIdeal.edadMin)
      .arg(resultado.clienteIdeal.edadMax)
-     .arg(resultado.clienteIdeal.sexo)
+     .arg(resultado.clienteIdeal.nombreSexo())
      .arg(resultado.clienteIdeal.requiereInternet ? "Sí" : "No")
-     .arg(gestorDatos->obtenerPoblacion().size());
+     .arg(static_cast<qlonglong>(gestorDatos->obtenerPoblacion().tamano()))
+     .arg(analisis.personasConPerfil)
+     .arg(QString::number(analizadorTrafico->obtenerSemilla()));
     
     infoAnalisis->setHtml(infoTexto);
     infoAnalisis->setStyleSheet("background-color: #f8f9fa; border: 1px solid #dee2e6; "
                                "border-radius: 5px; padding: 10px;");
     layout->addWidget(infoAnalisis);
     
+    // Curva de alcance: clientes esperados según el umbral de influenciabilidad.
+    // Un análisis cancelado no tiene curva: no se dibuja una parcial
+    if (analisis.completo) {
+        QLabel *tituloCurva = new QLabel("📉 <b>Curva de alcance</b> (línea: esperado e intervalo; "
+                                         "puntos: clientes potenciales)");
+        tituloCurva->setStyleSheet("font-size: 12px; color: #2c3e50;");
+        layout->addWidget(tituloCurva);
+        
+        GraficoAlcance *grafico = new GraficoAlcance();
+        grafico->establecerCurva(analisis.curva);
+        grafico->establecerUmbralMarcado(UMBRAL_POR_DEFECTO);
+        layout->addWidget(grafico, 1);
+    } else {
+        QLabel *sinCurva = new QLabel("📉 <i>La curva de alcance no se calculó: el análisis se canceló.</i>");
+        sinCurva->setStyleSheet("font-size: 12px; color: #6c757d;");
+        sinCurva->setAlignment(Qt::AlignCenter);
+        layout->addWidget(sinCurva, 1);
+    }
+    
     // Información adicional
     QLabel *infoAdicional = new QLabel(
         "ℹ️ <i>Este análisis se basa en criterios demográficos y patrones de consumo "
@@ -517,3 +849,9 @@ QString MainWindow::obtenerRutaCSV()
     std::cout << "Ruta de datos: " << rutaDatos.toStdString() << std::endl;
     return rutaDatos + "/poblacion_arequipa.csv";
 }
+
+QString MainWindow::obtenerRutaInstantanea()
+{
+    QString rutaDatos = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
+    return rutaDatos + "/poblacion_arequipa.pobl";
+}
@@ -17,10 +17,21 @@
 #include <QTextEdit>
 #include <QSplashScreen>
 #include <QTimer>
+#include <QFutureWatcher>
+#include <atomic>
+#include <memory>
 
 #include "../data_estructures/persona.h"
 #include "../data_estructures/gestor_datos.h"
 #include "../system/analizador_trafico.h"
+#include "grafico_alcance.h"
+
+// Lo que entrega un análisis en segundo plano
+struct ResultadoCurva {
+    QVector<PuntoAlcance> curva;     // Vacía si el análisis se canceló
+    int personasConPerfil = 0;       // Tráfico sin uplift, contado en el índice de mapas de bits
+    bool completo = false;           // False si se canceló antes de terminar la curva
+};
 
 QT_BEGIN_NAMESPACE
 namespace Ui {
@@ -38,9 +49,16 @@ public:
 
 private slots:
     void iniciarAnalisis();
+    void cancelarAnalisis();
+    void onAnalisisTerminado();
+    void onCargaTerminada();
     void onTipoEspacioChanged();
     void onEdadMinChanged();
     void onEdadMaxChanged();
+    void onEntradaCambiada();
+    void onModoEnVivoCambiado(bool activo);
+    void recalcularEnVivo();
+    void onEnVivoTerminado();
 
 private:
     Ui::MainWindow *ui;
@@ -69,8 +87,37 @@ private:
     
     // Botón de análisis y información
     QPushButton *btnIniciarAnalisis;
+    QPushButton *btnCancelarAnalisis;
+    QProgressBar *barraProgreso;
     QLabel *labelInfo;
     
+    // Carga de la población en segundo plano; el destructor la cancela
+    QSplashScreen *splash;
+    QFutureWatcher<void> *vigilanteCarga;
+    std::atomic<bool> cargaCancelada{false};
+    
+    // Análisis en segundo plano: la curva de alcance incluye el umbral por defecto
+    QFutureWatcher<ResultadoCurva> *vigilanteAnalisis;
+    std::shared_ptr<ControlAnalisis> controlAnalisis;
+    ResultadoAnalisis analisisEnCurso;
+    
+    // Modo en vivo: cada edición del formulario relanza el análisis tras una
+    // pausa y el resultado se muestra en la ventana; un cálculo en curso que
+    // queda obsoleto se cancela
+    QCheckBox *checkEnVivo;
+    QLabel *labelEnVivo;
+    GraficoAlcance *graficoEnVivo;
+    QTimer *temporizadorEnVivo;
+    QFutureWatcher<ResultadoCurva> *vigilanteEnVivo;
+    std::shared_ptr<ControlAnalisis> controlEnVivo;
+    bool recalculoPendiente;
+    bool poblacionLista;
+    static const int PAUSA_EN_VIVO_MS;
+    
+    // Conteos por edad de las consultas recientes: cambiar solo la edad o
+    // repetir una consulta no vuelve a recorrer la población
+    CacheConteos cacheConteos;
+    
     // Clases del sistema
     GestorDatos *gestorDatos;
     AnalizadorTrafico *analizadorTrafico;
@@ -79,15 +126,31 @@ private:
     void setupUI();
     void setupStyleSheet();
     void inicializarDatos();
-    void mostrarResultados(const ResultadoAnalisis& resultado);
+    void mostrarResultados(const ResultadoAnalisis& resultado, const ResultadoCurva& analisis);
     void mostrarSplashScreen();
     void validarEntradas();
     void actualizarRequiereInternet();
+    void restaurarEstadoAnalisis();
+    void actualizarProgresoCarga(const QString& etapa, int porcentaje);
+    
+    // Umbral de uplift del resultado principal y umbrales de la curva
+    static const double UMBRAL_POR_DEFECTO;
+    static QVector<double> umbralesCurva();
+    
+    // Curva de alcance de la consulta en segundo plano, usando la caché de
+    // conteos, y personas con el perfil según el índice de mapas de bits
+    QFuture<ResultadoCurva> lanzarAnalisis(const ClienteIdeal& cliente,
+                                           const QString& espacio,
+                                           const QString& producto,
+                                           const QString& tipoEspacio,
+                                           std::shared_ptr<ControlAnalisis> control);
+    static const PuntoAlcance* puntoPorDefecto(const QVector<PuntoAlcance>& curva);
     
     // Métodos de la interfaz
     void actualizarEspacios();
     ClienteIdeal obtenerClienteIdeal();
     QString obtenerRutaCSV();
+    QString obtenerRutaInstantanea();
 };
 
 #endif // MAINWINDOW_H